@@ -0,0 +1,89 @@
+#pragma once
+
+// Renders a block of automation into one unnormalized value per sample
+//
+// Hosts send dense automation as a handful of (sample offset, normalized value) points per block.
+// Interpolating those in the unnormalized domain bends a sweep on a logarithmicRange the wrong way,
+// and converting each sample through juce::NormalisableRange costs a std::function call per sample.
+// This interpolates the normalized values linearly between points, then converts the whole block at once:
+//
+//    melatonin::AutomationRenderer<melatonin::LogRange> cutoff { melatonin::LogRange (20.0f, 20000.0f, 10.0f) };
+//
+//    // in processBlock, points come from the host's parameter queue
+//    cutoff.render (points, numPoints, cutoffValues, numSamples);
+//
+// Each point is reached exactly at its sample offset. The block starts from the value the last one ended on,
+// and holds the last point until the end of the block. Points must be in order, when several share an offset the last one wins.
+//
+// Nothing allocates, points and destination are owned by the caller.
+// The range types (and LookupTableRange) convert in blocks, a juce::NormalisableRange falls back to one value at a time.
+namespace melatonin
+{
+    struct AutomationPoint
+    {
+        int sampleOffset = 0;
+        float normalized = 0.0f;
+    };
+
+    template <typename RangeType>
+    class AutomationRenderer
+    {
+    public:
+        explicit AutomationRenderer (const RangeType& rangeToUse, float initialNormalized = 0.0f) noexcept
+            : range (rangeToUse), lastNormalized (initialNormalized)
+        {
+        }
+
+        void render (const AutomationPoint* points, int numPoints, float* destination, int numSamples) noexcept
+        {
+            if (numSamples <= 0)
+                return;
+
+            int segmentStart = 0;
+            for (int p = 0; p < numPoints; ++p)
+            {
+                const auto& point = points[p];
+                jassert (point.sampleOffset >= segmentStart - 1 && point.sampleOffset < numSamples);
+                const auto segmentEnd = std::clamp (point.sampleOffset, std::max (segmentStart - 1, 0), numSamples - 1);
+
+                // another point on the same sample, the last one wins
+                if (segmentEnd < segmentStart)
+                {
+                    destination[segmentEnd] = lastNormalized = point.normalized;
+                    continue;
+                }
+
+                // a ramp that lands on the point's value at its offset
+                const auto numRamping = segmentEnd - segmentStart;
+                const auto slope = numRamping > 0 ? (point.normalized - lastNormalized) / (float) (numRamping + 1) : 0.0f;
+                for (int i = 0; i < numRamping; ++i)
+                    destination[segmentStart + i] = lastNormalized + slope * (float) (i + 1);
+
+                destination[segmentEnd] = point.normalized;
+                lastNormalized = point.normalized;
+                segmentStart = segmentEnd + 1;
+            }
+
+            if (segmentStart < numSamples)
+                juce::FloatVectorOperations::fill (destination + segmentStart, lastNormalized, numSamples - segmentStart);
+
+            convertFrom0to1 (range, destination, destination, numSamples);
+        }
+
+        template <typename Container>
+        void render (const Container& points, float* destination, int numSamples) noexcept
+        {
+            render (std::data (points), (int) std::size (points), destination, numSamples);
+        }
+
+        // Where the next block starts from, such as after the host jumps
+        void setCurrentNormalized (float normalized) noexcept { lastNormalized = normalized; }
+        [[nodiscard]] float getCurrentNormalized() const noexcept { return lastNormalized; }
+
+        [[nodiscard]] const RangeType& getRange() const noexcept { return range; }
+
+    private:
+        RangeType range;
+        float lastNormalized;
+    };
+}
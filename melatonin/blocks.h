@@ -0,0 +1,100 @@
+#pragma once
+
+// Block versions of the range factories in ranges.h
+//
+// Each factory gets a From0to1 and To0to1 companion that converts a whole span of values in one call,
+// taking the same arguments as the factory after the source, destination and count.
+// Source and destination may be the same pointer, so an AudioBuffer channel can be converted in place:
+//
+//    melatonin::logarithmicRangeFrom0to1 (buffer.getReadPointer (0), buffer.getWritePointer (0), buffer.getNumSamples(), 0.0f, 15.0f);
+//
+// These forward to the block methods of the types in range_types.h, so if you already hold one of those, call it directly.
+// The affine parts run through juce::FloatVectorOperations (SSE/NEON/vDSP).
+// The exp2/log2/pow stages use the same std:: functions as the lambdas, with every constant hoisted out of the loop.
+// Passing Accuracy::fast or Accuracy::fastest runs those stages through the SIMD kernels in fast_math.h instead.
+//
+// Results match the scalar juce::NormalisableRange conversions (including its clamping of normalized values to 0-1)
+// to within float rounding: a relative error under 1e-5 with an absolute floor of 1e-6 (see tests/ranges.cpp)
+namespace melatonin
+{
+    static inline void linearRangeFrom0to1 (const float* normalized, float* unnormalized, int numValues, const float start, const float end)
+    {
+        LinearRange (start, end).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void linearRangeTo0to1 (const float* unnormalized, float* normalized, int numValues, const float start, const float end)
+    {
+        LinearRange (start, end).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+
+    static inline void logarithmicRangeFrom0to1 (const float* normalized, float* unnormalized, int numValues, const float logStart, const float logEnd, const float exponent = 6.0f, Accuracy accuracy = Accuracy::exact)
+    {
+        LogRange (logStart, logEnd, exponent, accuracy).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void logarithmicRangeTo0to1 (const float* unnormalized, float* normalized, int numValues, const float logStart, const float logEnd, const float exponent = 6.0f, Accuracy accuracy = Accuracy::exact)
+    {
+        LogRange (logStart, logEnd, exponent, accuracy).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+
+    static inline void logarithmicRangeWithLinearStartFrom0to1 (const float* normalized, float* unnormalized, int numValues, const float logStart, const float logEnd, const float exponent, const float unnormalizedBreakpoint, const float breakpointOnSlider = 0.25f, Accuracy accuracy = Accuracy::exact)
+    {
+        LogRangeWithLinearStart (logStart, logEnd, exponent, unnormalizedBreakpoint, breakpointOnSlider, accuracy).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void logarithmicRangeWithLinearStartTo0to1 (const float* unnormalized, float* normalized, int numValues, const float logStart, const float logEnd, const float exponent, const float unnormalizedBreakpoint, const float breakpointOnSlider = 0.25f, Accuracy accuracy = Accuracy::exact)
+    {
+        LogRangeWithLinearStart (logStart, logEnd, exponent, unnormalizedBreakpoint, breakpointOnSlider, accuracy).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+
+    static inline void reversedLogarithmicRangeFrom0to1 (const float* normalized, float* unnormalized, int numValues, const float logStart, const float logEnd, const float exponent = 6.0f, Accuracy accuracy = Accuracy::exact)
+    {
+        reversed (LogRange (logStart, logEnd, exponent, accuracy)).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void reversedLogarithmicRangeTo0to1 (const float* unnormalized, float* normalized, int numValues, const float logStart, const float logEnd, const float exponent = 6.0f, Accuracy accuracy = Accuracy::exact)
+    {
+        reversed (LogRange (logStart, logEnd, exponent, accuracy)).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+
+    static inline void intRangeWithMidPointFrom0to1 (const float* normalized, float* unnormalized, int numValues, int min, int max, int midpoint)
+    {
+        IntRangeWithMidPoint (min, max, midpoint).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void intRangeWithMidPointTo0to1 (const float* unnormalized, float* normalized, int numValues, int min, int max, int midpoint)
+    {
+        IntRangeWithMidPoint (min, max, midpoint).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+
+    static inline void decibelRangeForHarmonicFrom0to1 (const float* normalized, float* unnormalized, int numValues, size_t harmonicNumber, float minimum = -100.f, Accuracy accuracy = Accuracy::exact)
+    {
+        HarmonicDecibelRange (harmonicNumber, minimum, accuracy).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void decibelRangeForHarmonicTo0to1 (const float* unnormalized, float* normalized, int numValues, size_t harmonicNumber, float minimum = -100.f, Accuracy accuracy = Accuracy::exact)
+    {
+        HarmonicDecibelRange (harmonicNumber, minimum, accuracy).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+
+    static inline void decibelRangeFrom0to1 (const float* normalized, float* unnormalized, int numValues, Accuracy accuracy = Accuracy::exact)
+    {
+        decibelRangeForHarmonicFrom0to1 (normalized, unnormalized, numValues, 1, -100.f, accuracy);
+    }
+
+    static inline void decibelRangeTo0to1 (const float* unnormalized, float* normalized, int numValues, Accuracy accuracy = Accuracy::exact)
+    {
+        decibelRangeForHarmonicTo0to1 (unnormalized, normalized, numValues, 1, -100.f, accuracy);
+    }
+
+    // linear in dB, so there's no accuracy to pick
+    static inline void decibelRangeFrom0to1 (const float* normalized, float* unnormalized, int numValues, float minimum, float maximum)
+    {
+        DecibelRange (minimum, maximum).convertFrom0to1 (normalized, unnormalized, numValues);
+    }
+
+    static inline void decibelRangeTo0to1 (const float* unnormalized, float* normalized, int numValues, float minimum, float maximum)
+    {
+        DecibelRange (minimum, maximum).convertTo0to1 (unnormalized, normalized, numValues);
+    }
+}
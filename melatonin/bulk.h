@@ -0,0 +1,108 @@
+#pragma once
+
+// Converting, formatting and parsing whole arrays at once, across a juce::ThreadPool
+//
+// Re-indexing a preset library means millions of values going to and from text and 0-1.
+// These split the work into chunks, run them on the pool (and the calling thread), and return when every chunk is done:
+//
+//    juce::ThreadPool pool;
+//    melatonin::bulk::format<melatonin::formatters::Hz> (frequencies.data(), labels.data(), numValues, &pool);
+//    melatonin::bulk::parse<melatonin::parsers::Hz> (texts.data(), results.data(), numValues, &pool);
+//
+// Without a pool everything happens on the calling thread.
+// Each value only depends on itself, and chunks are a multiple of 64 values, so block conversions see the same
+// SIMD groups they would serially: the results are identical to the serial path, no matter the number of threads.
+//
+// Every range, formatter and parser in this module is safe to call from several threads at once,
+// but a custom one passed to transform has to be too.
+namespace melatonin::bulk
+{
+    static constexpr int defaultChunkSize = 4096;
+
+    // Calls processChunk (start, end) for consecutive chunks covering 0 to numItems, in parallel on the pool
+    // chunkSize is rounded up to a multiple of 64
+    template <typename ChunkFunction>
+    static inline void forEachChunk (int numItems, ChunkFunction&& processChunk, juce::ThreadPool* pool = nullptr, int chunkSize = defaultChunkSize)
+    {
+        chunkSize = std::max (64, (chunkSize + 63) / 64 * 64);
+        const auto numChunks = (numItems + chunkSize - 1) / chunkSize;
+
+        if (pool == nullptr || numChunks <= 1)
+        {
+            for (int start = 0; start < numItems; start += chunkSize)
+                processChunk (start, std::min (start + chunkSize, numItems));
+            return;
+        }
+
+        // whoever is free takes the next chunk, which chunk lands on which thread doesn't change the output
+        std::atomic<int> nextChunk { 0 };
+        auto work = [&] {
+            for (auto chunk = nextChunk.fetch_add (1); chunk < numChunks; chunk = nextChunk.fetch_add (1))
+            {
+                const auto start = chunk * chunkSize;
+                processChunk (start, std::min (start + chunkSize, numItems));
+            }
+        };
+
+        // the calling thread works too, so one less job than there are threads (or chunks)
+        const auto numJobs = std::min (pool->getNumThreads(), numChunks) - 1;
+        std::atomic<int> numJobsRunning { numJobs };
+        juce::WaitableEvent allJobsFinished;
+        for (int i = 0; i < numJobs; ++i)
+        {
+            pool->addJob ([&] {
+                work();
+                if (numJobsRunning.fetch_sub (1) == 1)
+                    allJobsFinished.signal();
+            });
+        }
+
+        work();
+
+        // the jobs reference this stack frame, so wait for all of them, not just for the chunks to be done
+        if (numJobs > 0)
+            allJobsFinished.wait();
+    }
+
+    // destination[i] = function (source[i])
+    template <typename Source, typename Destination, typename Function>
+    static inline void transform (const Source* source, Destination* destination, int numItems, Function&& function, juce::ThreadPool* pool = nullptr, int chunkSize = defaultChunkSize)
+    {
+        forEachChunk (
+            numItems, [&] (int start, int end) {
+                for (int i = start; i < end; ++i)
+                    destination[i] = function (source[i]);
+            },
+            pool,
+            chunkSize);
+    }
+
+    // Through the range's block conversion when it has one (see range_types.h)
+    template <typename RangeType>
+    static inline void convertFrom0to1 (const RangeType& range, const float* normalized, float* unnormalized, int numValues, juce::ThreadPool* pool = nullptr, int chunkSize = defaultChunkSize)
+    {
+        forEachChunk (
+            numValues, [&] (int start, int end) { melatonin::convertFrom0to1 (range, normalized + start, unnormalized + start, end - start); }, pool, chunkSize);
+    }
+
+    template <typename RangeType>
+    static inline void convertTo0to1 (const RangeType& range, const float* unnormalized, float* normalized, int numValues, juce::ThreadPool* pool = nullptr, int chunkSize = defaultChunkSize)
+    {
+        forEachChunk (
+            numValues, [&] (int start, int end) { melatonin::convertTo0to1 (range, unnormalized + start, normalized + start, end - start); }, pool, chunkSize);
+    }
+
+    // The same text as the stringFrom* lambda matching Formatter
+    template <typename Formatter, typename ValueType>
+    static inline void format (const ValueType* values, juce::String* texts, int numValues, juce::ThreadPool* pool = nullptr, int maximumStringLength = Formatter::defaultMaximumStringLength)
+    {
+        transform (values, texts, numValues, [maximumStringLength] (ValueType value) { return formatToString<Formatter> (value, maximumStringLength); }, pool);
+    }
+
+    // Strict parsing, see melatonin::parse in parsers.h
+    template <typename UnitPolicy, typename FloatType = float>
+    static inline void parse (const std::string_view* texts, parsers::ParseResult<FloatType>* results, int numTexts, juce::ThreadPool* pool = nullptr)
+    {
+        transform (texts, results, numTexts, [] (std::string_view text) { return melatonin::parse<UnitPolicy, FloatType> (text); }, pool);
+    }
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+// Any of the ranges in ranges.h in 32 bytes, for storing thousands of them
+//
+// A juce::NormalisableRange<float> carries three std::functions and their captures, well over 100 bytes
+// (plus whatever they allocate) for every parameter of every plugin instance.
+// CompactRange is a kind tag and a handful of floats, and a switch on the kind picks the conversion:
+//
+//    std::vector<melatonin::CompactRange> ranges;
+//    ranges.push_back (melatonin::CompactRange::log (0.0f, 15.0f));
+//    juce::AudioParameterFloat ("release", "Release", ranges.back(), 0.1f); // a NormalisableRange only at the APVTS
+//
+// Each kind converts exactly like the matching type in range_types.h.
+// The less common constants (like the slopes of logWithLinearStart) are worked out on the fly instead of stored.
+namespace melatonin
+{
+    class CompactRange
+    {
+    public:
+        enum class Kind : uint8_t {
+            linear,
+            log,
+            logWithLinearStart,
+            decibels,
+            harmonicDecibels,
+            intWithMidPoint
+        };
+
+        [[nodiscard]] static constexpr CompactRange linear (float start, float end) noexcept
+        {
+            return { Kind::linear, Accuracy::exact, start, end, { end - start, 1.0f / (end - start) } };
+        }
+
+        [[nodiscard]] static constexpr CompactRange log (float logStart, float logEnd, float exponent = 6.0f, Accuracy accuracy = Accuracy::exact) noexcept
+        {
+            const auto scale = (logEnd - logStart) / (float) (fastmath::constexprExp2 (exponent) - 1);
+            return { Kind::log, accuracy, logStart, logEnd, { exponent, 1.0f / exponent, scale, 1.0f / scale } };
+        }
+
+        [[nodiscard]] static constexpr CompactRange logWithLinearStart (float logStart, float logEnd, float exponent, float unnormalizedBreakpoint, float breakpointOnSlider = 0.25f, Accuracy accuracy = Accuracy::exact) noexcept
+        {
+            const auto scale = (logEnd - unnormalizedBreakpoint) / (float) (fastmath::constexprExp2 (exponent) - 1);
+            return { Kind::logWithLinearStart, accuracy, logStart, logEnd, { exponent, unnormalizedBreakpoint, breakpointOnSlider, scale, 1.0f / scale } };
+        }
+
+        // linear in dB, so there's no accuracy (and two of these with the same limits are always equal)
+        [[nodiscard]] static constexpr CompactRange decibels (float minimum, float maximum) noexcept
+        {
+            return { Kind::decibels, Accuracy::exact, minimum, maximum, { maximum - minimum, 1.0f / (maximum - minimum) } };
+        }
+
+        [[nodiscard]] static constexpr CompactRange decibelsForHarmonic (size_t harmonicNumber, float minimum = -100.f, Accuracy accuracy = Accuracy::exact) noexcept
+        {
+            const auto maximum = std::max (minimum, (float) (-20.0 * fastmath::constexprLog2 ((double) harmonicNumber) * 0.3010299956639812));
+            return { Kind::harmonicDecibels, accuracy, minimum, maximum, { (float) harmonicNumber, 1.0f / (float) harmonicNumber } };
+        }
+
+        [[nodiscard]] static constexpr CompactRange intWithMidPoint (int min, int max, int midpoint) noexcept
+        {
+            const auto lower = (float) midpoint - (float) min;
+            const auto upper = (float) max - (float) midpoint;
+            return { Kind::intWithMidPoint, Accuracy::exact, (float) min, (float) max, { (float) midpoint, 2.0f * lower, 2.0f * upper, 0.5f / lower, 0.5f / upper } };
+        }
+
+        // Each kind's curve is the one from its range type in range_types.h, fed the stored constants
+        [[nodiscard]] float convertFrom0to1 (float normalized) const noexcept
+        {
+            const auto& p = parameters;
+            switch (kind)
+            {
+                case Kind::log: return LogRange::from0to1 (normalized, start, p[0], p[2], getAccuracy());
+                case Kind::logWithLinearStart: return LogRangeWithLinearStart::from0to1 (normalized, p[1], p[2], (p[1] - start) / p[2], p[0] / (1.0f - p[2]), p[3], getAccuracy());
+                case Kind::harmonicDecibels: return HarmonicDecibelRange::from0to1 (normalized, p[1], start, getAccuracy());
+                case Kind::intWithMidPoint: return IntRangeWithMidPoint::from0to1 (normalized, start, end, p[0], p[1], p[2]);
+                case Kind::linear:
+                case Kind::decibels: break;
+            }
+            return LinearRange::from0to1 (normalized, start, p[0]);
+        }
+
+        [[nodiscard]] float convertTo0to1 (float unnormalized) const noexcept
+        {
+            const auto& p = parameters;
+            switch (kind)
+            {
+                case Kind::log: return LogRange::to0to1 (unnormalized, start, p[1], p[3], getAccuracy());
+                case Kind::logWithLinearStart: return LogRangeWithLinearStart::to0to1 (unnormalized, p[1], p[2], p[2] / p[1], (1.0f - p[2]) / p[0], p[4], getAccuracy());
+                case Kind::harmonicDecibels: return HarmonicDecibelRange::to0to1 (unnormalized, p[0], start, getAccuracy());
+                case Kind::intWithMidPoint: return IntRangeWithMidPoint::to0to1 (unnormalized, start, p[0], p[3], p[4]);
+                case Kind::linear:
+                case Kind::decibels: break;
+            }
+            return LinearRange::to0to1 (unnormalized, start, p[1]);
+        }
+
+        // The switch happens once per block, and each kind runs the same block kernels as its range type
+        // (with the same operations in the same order as one value at a time, so the results are identical)
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            const auto& p = parameters;
+            switch (kind)
+            {
+                case Kind::log:
+                    // start + (2^kx - 1) * scale
+                    juce::FloatVectorOperations::clip (unnormalized, normalized, 0.0f, 1.0f, numValues);
+                    juce::FloatVectorOperations::multiply (unnormalized, p[0], numValues);
+                    fastmath::exp2 (unnormalized, unnormalized, numValues, getAccuracy());
+                    juce::FloatVectorOperations::add (unnormalized, -1.0f, numValues);
+                    juce::FloatVectorOperations::multiply (unnormalized, p[2], numValues);
+                    juce::FloatVectorOperations::add (unnormalized, start, numValues);
+                    return;
+                case Kind::harmonicDecibels:
+                    juce::FloatVectorOperations::clip (unnormalized, normalized, 0.0f, 1.0f, numValues);
+                    juce::FloatVectorOperations::multiply (unnormalized, p[1], numValues);
+                    fastmath::gainToDecibels (unnormalized, unnormalized, numValues, start, getAccuracy());
+                    return;
+                case Kind::logWithLinearStart:
+                    return LogRangeWithLinearStart (start, end, p[0], p[1], p[2], getAccuracy()).convertFrom0to1 (normalized, unnormalized, numValues);
+                case Kind::intWithMidPoint:
+                    return IntRangeWithMidPoint ((int) start, (int) end, (int) p[0]).convertFrom0to1 (normalized, unnormalized, numValues);
+                case Kind::linear:
+                case Kind::decibels:
+                    break;
+            }
+
+            juce::FloatVectorOperations::clip (unnormalized, normalized, 0.0f, 1.0f, numValues);
+            juce::FloatVectorOperations::multiply (unnormalized, p[0], numValues);
+            juce::FloatVectorOperations::add (unnormalized, start, numValues);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            const auto& p = parameters;
+            switch (kind)
+            {
+                case Kind::log:
+                    // log2 ((x - start) / scale + 1) / k
+                    juce::FloatVectorOperations::add (normalized, unnormalized, -start, numValues);
+                    juce::FloatVectorOperations::multiply (normalized, p[3], numValues);
+                    juce::FloatVectorOperations::add (normalized, 1.0f, numValues);
+                    fastmath::log2 (normalized, normalized, numValues, getAccuracy());
+                    juce::FloatVectorOperations::multiply (normalized, p[1], numValues);
+                    break;
+                case Kind::harmonicDecibels:
+                    fastmath::decibelsToGain (unnormalized, normalized, numValues, start, getAccuracy());
+                    juce::FloatVectorOperations::multiply (normalized, p[0], numValues);
+                    break;
+                case Kind::logWithLinearStart:
+                    return LogRangeWithLinearStart (start, end, p[0], p[1], p[2], getAccuracy()).convertTo0to1 (unnormalized, normalized, numValues);
+                case Kind::intWithMidPoint:
+                    return IntRangeWithMidPoint ((int) start, (int) end, (int) p[0]).convertTo0to1 (unnormalized, normalized, numValues);
+                case Kind::linear:
+                case Kind::decibels:
+                    juce::FloatVectorOperations::add (normalized, unnormalized, -start, numValues);
+                    juce::FloatVectorOperations::multiply (normalized, p[1], numValues);
+                    break;
+            }
+
+            juce::FloatVectorOperations::clip (normalized, normalized, 0.0f, 1.0f, numValues);
+        }
+
+        [[nodiscard]] constexpr Kind getKind() const noexcept { return kind; }
+        [[nodiscard]] constexpr float getStart() const noexcept { return start; }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return end; }
+        [[nodiscard]] constexpr Accuracy getAccuracy() const noexcept { return (Accuracy) accuracy; }
+
+        // Two ranges are equal when they convert the same, which is when they were made from the same arguments
+        [[nodiscard]] constexpr bool operator== (const CompactRange& other) const noexcept
+        {
+            return kind == other.kind && accuracy == other.accuracy && start == other.start && end == other.end
+                   && parameters[0] == other.parameters[0] && parameters[1] == other.parameters[1] && parameters[2] == other.parameters[2]
+                   && parameters[3] == other.parameters[3] && parameters[4] == other.parameters[4];
+        }
+
+        [[nodiscard]] constexpr bool operator!= (const CompactRange& other) const noexcept { return ! (*this == other); }
+
+        // Combines every field, for keeping ranges in a hash map
+        [[nodiscard]] size_t hash() const noexcept
+        {
+            auto combine = [] (size_t seed, size_t value) { return seed ^ (value + (size_t) 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)); };
+            auto result = combine ((size_t) kind, (size_t) accuracy);
+            result = combine (result, std::hash<float>() (start));
+            result = combine (result, std::hash<float>() (end));
+            for (auto parameter : parameters)
+                result = combine (result, std::hash<float>() (parameter));
+            return result;
+        }
+
+        // Through the matching type in range_types.h, whose converters fit in a std::function without allocating
+        // (capturing the whole 32 bytes would allocate on every copy of the NormalisableRange)
+        // Like IntRangeWithMidPoint, the int kind snaps to whole numbers and has an interval of 1
+        operator juce::NormalisableRange<float>() const
+        {
+            const auto& p = parameters;
+            switch (kind)
+            {
+                case Kind::log: return LogRange (start, end, p[0], getAccuracy());
+                case Kind::logWithLinearStart: return LogRangeWithLinearStart (start, end, p[0], p[1], p[2], getAccuracy());
+                case Kind::decibels: return DecibelRange (start, end);
+                case Kind::harmonicDecibels: return HarmonicDecibelRange ((size_t) p[0], start, getAccuracy());
+                case Kind::intWithMidPoint: return IntRangeWithMidPoint ((int) start, (int) end, (int) p[0]);
+                case Kind::linear: break;
+            }
+            return LinearRange (start, end);
+        }
+
+    private:
+        Kind kind;
+        uint8_t accuracy;
+        float start, end;
+
+        // What each kind keeps
+        //  * linear:             length, 1 / length
+        //  * log:                exponent, 1 / exponent, (end - start) / (2^exponent - 1) and its inverse
+        //  * logWithLinearStart: exponent, unnormalized breakpoint, breakpoint on the slider, (end - breakpoint) / (2^exponent - 1) and its inverse
+        //  * decibels:           length in dB, 1 / length (it's linear in dB)
+        //  * harmonicDecibels:   harmonic number, 1 / harmonic number
+        //  * intWithMidPoint:    midpoint, the slopes below and above it from 0-1, then to 0-1
+        std::array<float, 5> parameters;
+
+        constexpr CompactRange (Kind kindToUse, Accuracy accuracyToUse, float startToUse, float endToUse, std::array<float, 5> parametersToUse) noexcept
+            : kind (kindToUse), accuracy ((uint8_t) accuracyToUse), start (startToUse), end (endToUse), parameters (parametersToUse)
+        {
+        }
+    };
+
+    static_assert (sizeof (CompactRange) <= 32);
+}
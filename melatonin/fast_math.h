@@ -0,0 +1,366 @@
+#pragma once
+
+// Polynomial approximations of the transcendentals behind the ranges
+//
+// The log and decibel ranges spend most of their time in exp2, log2, pow and log10.
+// At sample rate that adds up, so every range that uses them takes an Accuracy:
+//
+//  * exact:   the std:: functions, results are identical to before
+//  * fast:    5th order exp2, 8th order log2. Relative error of exp2 under 2e-6, absolute error of log2 under 2e-6
+//  * fastest: 3rd order exp2, 4th order log2. Relative error of exp2 under 2e-4, absolute error of log2 under 2e-4
+//
+// The fast polynomials themselves are good to about 1e-7, the rest of its budget is float rounding,
+// which grows with the size of the input (log2 of a million is already 20).
+// pow10 and log10 are built on exp2 and log2 and land within the same budgets for the -120 to +120dB range.
+// tests/fast_math.cpp checks each tier against its budget.
+//
+// Inputs are expected to be normal floats. exp2 flushes to 0 below -126 (so -inf gives 0) and saturates above 127,
+// log2 treats anything at or below 0 as the smallest normal float (so gives -126).
+// NaN goes to the bottom of both, giving 0 and -126, the same in every lane and one value at a time.
+namespace melatonin
+{
+    enum class Accuracy {
+        exact,
+        fast,
+        fastest
+    };
+
+    namespace fastmath
+    {
+        // Minimax polynomials, fit to relative error for exp2 and absolute error for log2.
+        // exp2 is fit as 2^f = 1 + f * p (f) on 0 to 1, so whole powers of 2 come out exactly.
+        // log2 is fit as log2 (1 + t) = t * q (t) on sqrt (0.5) - 1 to sqrt (2) - 1, so log2 (1) is exactly 0.
+        template <Accuracy accuracy, typename Vec>
+        inline Vec exp2 (Vec x) noexcept
+        {
+            static_assert (accuracy != Accuracy::exact, "use std::exp2");
+            // -127 leaves the exponent bits at 0, which flushes the result to 0
+            // max lets NaN through (and SSE and scalar disagree on it), a select on the comparison sends it to -127
+            const auto lowest = simd::broadcast<Vec> (-127.0f);
+            x = simd::select (simd::isBelow (lowest, x), simd::min (x, simd::broadcast<Vec> (127.0f)), lowest);
+            const auto whole = simd::floor (x);
+            const auto f = simd::sub (x, whole);
+
+            Vec p;
+            if constexpr (accuracy == Accuracy::fast)
+            {
+                p = simd::add (simd::broadcast<Vec> (0.009017028800908341f), simd::mul (f, simd::broadcast<Vec> (0.001867130638141729f)));
+                p = simd::add (simd::broadcast<Vec> (0.055799914541922596f), simd::mul (f, p));
+                p = simd::add (simd::broadcast<Vec> (0.24016444959920574f), simd::mul (f, p));
+                p = simd::add (simd::broadcast<Vec> (0.6931513118758678f), simd::mul (f, p));
+            }
+            else
+            {
+                p = simd::add (simd::broadcast<Vec> (0.22764495351262862f), simd::mul (f, simd::broadcast<Vec> (0.07706706376384832f)));
+                p = simd::add (simd::broadcast<Vec> (0.6951168020355117f), simd::mul (f, p));
+            }
+            p = simd::add (simd::broadcast<Vec> (1.0f), simd::mul (f, p));
+
+            // 2^whole, built straight into the exponent bits
+            const auto exponent = simd::shiftLeft<23> (simd::addInt (simd::truncateToInt (whole), simd::broadcastInt (x, 127)));
+            return simd::mul (p, simd::asFloat (exponent));
+        }
+
+        template <Accuracy accuracy, typename Vec>
+        inline Vec log2 (Vec x) noexcept
+        {
+            static_assert (accuracy != Accuracy::exact, "use std::log2");
+            const auto smallest = simd::broadcast<Vec> (std::numeric_limits<float>::min());
+            x = simd::select (simd::isBelow (smallest, x), x, smallest);
+
+            // split into 2^exponent * m, with m between sqrt (0.5) and sqrt (2)
+            const auto bits = simd::asInt (x);
+            const auto exponent = simd::shiftRightArithmetic<23> (simd::subInt (bits, simd::broadcastInt (x, 0x3f3504f3)));
+            const auto t = simd::sub (simd::asFloat (simd::subInt (bits, simd::shiftLeft<23> (exponent))), simd::broadcast<Vec> (1.0f));
+
+            Vec q;
+            if constexpr (accuracy == Accuracy::fast)
+            {
+                q = simd::add (simd::broadcast<Vec> (0.2368897852960387f), simd::mul (t, simd::broadcast<Vec> (-0.1457429501565614f)));
+                q = simd::add (simd::broadcast<Vec> (-0.25006930801067834f), simd::mul (t, q));
+                q = simd::add (simd::broadcast<Vec> (0.2867075461916888f), simd::mul (t, q));
+                q = simd::add (simd::broadcast<Vec> (-0.36008719982594756f), simd::mul (t, q));
+                q = simd::add (simd::broadcast<Vec> (0.4809394411551172f), simd::mul (t, q));
+                q = simd::add (simd::broadcast<Vec> (-0.7213571492585759f), simd::mul (t, q));
+                q = simd::add (simd::broadcast<Vec> (1.4426947724529442f), simd::mul (t, q));
+            }
+            else
+            {
+                q = simd::add (simd::broadcast<Vec> (0.5175091494484106f), simd::mul (t, simd::broadcast<Vec> (-0.329627514288396f)));
+                q = simd::add (simd::broadcast<Vec> (-0.7249043876016148f), simd::mul (t, q));
+                q = simd::add (simd::broadcast<Vec> (1.4417606486046435f), simd::mul (t, q));
+            }
+
+            return simd::add (simd::toFloat (exponent), simd::mul (t, q));
+        }
+
+        template <Accuracy accuracy, typename Vec>
+        inline Vec pow10 (Vec x) noexcept
+        {
+            return exp2<accuracy> (simd::mul (x, simd::broadcast<Vec> (3.321928094887362f)));
+        }
+
+        template <Accuracy accuracy, typename Vec>
+        inline Vec log10 (Vec x) noexcept
+        {
+            return simd::mul (log2<accuracy> (x), simd::broadcast<Vec> (0.3010299956639812f));
+        }
+
+        // Calls function with the tier as a compile time constant (a std::integral_constant),
+        // for code that wants to pick it once rather than on every call
+        template <typename Function>
+        inline auto withAccuracy (Accuracy accuracy, Function&& function)
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return function (std::integral_constant<Accuracy, Accuracy::fast>());
+                case Accuracy::fastest: return function (std::integral_constant<Accuracy, Accuracy::fastest>());
+                case Accuracy::exact: break;
+            }
+            return function (std::integral_constant<Accuracy, Accuracy::exact>());
+        }
+
+        // Scalar versions that pick the tier at runtime, for use in the range lambdas
+        inline float exp2 (float x, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return exp2<Accuracy::fast> (x);
+                case Accuracy::fastest: return exp2<Accuracy::fastest> (x);
+                case Accuracy::exact: break;
+            }
+            return std::exp2 (x);
+        }
+
+        inline float log2 (float x, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return log2<Accuracy::fast> (x);
+                case Accuracy::fastest: return log2<Accuracy::fastest> (x);
+                case Accuracy::exact: break;
+            }
+            return std::log2 (x);
+        }
+
+        inline float pow10 (float x, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return pow10<Accuracy::fast> (x);
+                case Accuracy::fastest: return pow10<Accuracy::fastest> (x);
+                case Accuracy::exact: break;
+            }
+            return std::pow (10.0f, x);
+        }
+
+        inline float log10 (float x, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return log10<Accuracy::fast> (x);
+                case Accuracy::fastest: return log10<Accuracy::fastest> (x);
+                case Accuracy::exact: break;
+            }
+            return std::log10 (x);
+        }
+
+        // natural log
+        inline float log (float x, Accuracy accuracy) noexcept
+        {
+            if (accuracy == Accuracy::exact)
+                return std::log (x);
+
+            return log2 (x, accuracy) * 0.6931471805599453f;
+        }
+
+        inline float pow (float base, float exponent, Accuracy accuracy) noexcept
+        {
+            if (accuracy == Accuracy::exact)
+                return std::pow (base, exponent);
+
+            return exp2 (exponent * log2 (base, accuracy), accuracy);
+        }
+
+        // Same behavior as juce::Decibels
+        inline float gainToDecibels (float gain, float minusInfinityDb, Accuracy accuracy) noexcept
+        {
+            if (accuracy == Accuracy::exact)
+                return juce::Decibels::gainToDecibels (gain, minusInfinityDb);
+
+            return gain > 0.0f ? std::max (minusInfinityDb, log10 (gain, accuracy) * 20.0f) : minusInfinityDb;
+        }
+
+        inline float decibelsToGain (float decibels, float minusInfinityDb, Accuracy accuracy) noexcept
+        {
+            if (accuracy == Accuracy::exact)
+                return juce::Decibels::decibelsToGain (decibels, minusInfinityDb);
+
+            return decibels > minusInfinityDb ? pow10 (decibels * 0.05f, accuracy) : 0.0f;
+        }
+
+        // Double versions, for the double precision ranges
+        // exact stays in double, the fast tiers run the float polynomials (their error is far above float rounding anyway)
+        inline double exp2 (double x, Accuracy accuracy) noexcept
+        {
+            return accuracy == Accuracy::exact ? std::exp2 (x) : (double) exp2 ((float) x, accuracy);
+        }
+
+        inline double log2 (double x, Accuracy accuracy) noexcept
+        {
+            return accuracy == Accuracy::exact ? std::log2 (x) : (double) log2 ((float) x, accuracy);
+        }
+
+        inline double pow10 (double x, Accuracy accuracy) noexcept
+        {
+            return accuracy == Accuracy::exact ? std::pow (10.0, x) : (double) pow10 ((float) x, accuracy);
+        }
+
+        inline double log10 (double x, Accuracy accuracy) noexcept
+        {
+            return accuracy == Accuracy::exact ? std::log10 (x) : (double) log10 ((float) x, accuracy);
+        }
+
+        inline double log (double x, Accuracy accuracy) noexcept
+        {
+            return accuracy == Accuracy::exact ? std::log (x) : (double) log ((float) x, accuracy);
+        }
+
+        inline double pow (double base, double exponent, Accuracy accuracy) noexcept
+        {
+            return accuracy == Accuracy::exact ? std::pow (base, exponent) : (double) pow ((float) base, (float) exponent, accuracy);
+        }
+
+        inline double gainToDecibels (double gain, double minusInfinityDb, Accuracy accuracy) noexcept
+        {
+            if (accuracy == Accuracy::exact)
+                return juce::Decibels::gainToDecibels (gain, minusInfinityDb);
+
+            return gain > 0.0 ? std::max (minusInfinityDb, log10 (gain, accuracy) * 20.0) : minusInfinityDb;
+        }
+
+        inline double decibelsToGain (double decibels, double minusInfinityDb, Accuracy accuracy) noexcept
+        {
+            if (accuracy == Accuracy::exact)
+                return juce::Decibels::decibelsToGain (decibels, minusInfinityDb);
+
+            return decibels > minusInfinityDb ? pow10 (decibels * 0.05, accuracy) : 0.0;
+        }
+
+        // Compile time versions, std::exp2 and std::log2 aren't constexpr until C++26
+        // These are for working out a range's constants, not for audio rate work.
+        // They match std:: to within a few ulps of a double for inputs a range would see (exponents up to a few hundred)
+        constexpr double constexprExp2 (double x) noexcept
+        {
+            // 2^x = 2^whole * e^(fraction * ln 2), with the fraction between -0.5 and 0.5
+            auto whole = (int64_t) (x < 0 ? x - 0.5 : x + 0.5);
+            const auto f = (x - (double) whole) * 0.6931471805599453;
+
+            // Taylor series, f is under ln 2 / 2 so 1/13! is the last term that matters
+            constexpr double inverseFactorials[] = { 1.0, 1.0, 0.5, 0.16666666666666666, 0.041666666666666664, 0.008333333333333333, 0.001388888888888889,
+                                                     0.0001984126984126984, 2.48015873015873e-05, 2.7557319223985893e-06, 2.755731922398589e-07,
+                                                     2.505210838544172e-08, 2.08767569878681e-09, 1.6059043836821613e-10 };
+            double sum = 0.0;
+            for (int i = 13; i >= 0; --i)
+                sum = sum * f + inverseFactorials[i];
+
+            // 2^whole by squaring
+            double power = 1.0, base = whole < 0 ? 0.5 : 2.0;
+            for (auto n = whole < 0 ? -whole : whole; n > 0; n >>= 1, base *= base)
+                if (n & 1)
+                    power *= base;
+            return sum * power;
+        }
+
+        // x must be above 0
+        constexpr double constexprLog2 (double x) noexcept
+        {
+            // log2 (x) = whole + log2 (m), with m between 1 and 2
+            double whole = 0.0;
+            for (; x >= 2.0; ++whole)
+                x *= 0.5;
+            for (; x < 1.0; --whole)
+                x *= 2.0;
+
+            // ln (m) = 2 * atanh ((m - 1) / (m + 1)), z is at most 1/3 so the series converges quickly
+            const auto z = (x - 1.0) / (x + 1.0);
+            double term = z, sum = 0.0;
+            for (int i = 0; i < 30; ++i)
+            {
+                sum += term / (2 * i + 1);
+                term *= z * z;
+            }
+            return whole + 2.0 * sum * 1.4426950408889634;
+        }
+
+        // Block versions, SIMD for the fast tiers. Source and destination may be the same.
+        inline void exp2 (const float* source, float* destination, int numValues, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return simd::apply (source, destination, numValues, [] (auto x) { return exp2<Accuracy::fast> (x); });
+                case Accuracy::fastest: return simd::apply (source, destination, numValues, [] (auto x) { return exp2<Accuracy::fastest> (x); });
+                case Accuracy::exact: break;
+            }
+            for (int i = 0; i < numValues; ++i)
+                destination[i] = std::exp2 (source[i]);
+        }
+
+        inline void log2 (const float* source, float* destination, int numValues, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return simd::apply (source, destination, numValues, [] (auto x) { return log2<Accuracy::fast> (x); });
+                case Accuracy::fastest: return simd::apply (source, destination, numValues, [] (auto x) { return log2<Accuracy::fastest> (x); });
+                case Accuracy::exact: break;
+            }
+            for (int i = 0; i < numValues; ++i)
+                destination[i] = std::log2 (source[i]);
+        }
+
+        inline void pow10 (const float* source, float* destination, int numValues, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return simd::apply (source, destination, numValues, [] (auto x) { return pow10<Accuracy::fast> (x); });
+                case Accuracy::fastest: return simd::apply (source, destination, numValues, [] (auto x) { return pow10<Accuracy::fastest> (x); });
+                case Accuracy::exact: break;
+            }
+            for (int i = 0; i < numValues; ++i)
+                destination[i] = std::pow (10.0f, source[i]);
+        }
+
+        inline void log10 (const float* source, float* destination, int numValues, Accuracy accuracy) noexcept
+        {
+            switch (accuracy)
+            {
+                case Accuracy::fast: return simd::apply (source, destination, numValues, [] (auto x) { return log10<Accuracy::fast> (x); });
+                case Accuracy::fastest: return simd::apply (source, destination, numValues, [] (auto x) { return log10<Accuracy::fastest> (x); });
+                case Accuracy::exact: break;
+            }
+            for (int i = 0; i < numValues; ++i)
+                destination[i] = std::log10 (source[i]);
+        }
+
+        // Block versions of gainToDecibels and decibelsToGain, for metering and gain staging
+        inline void gainToDecibels (const float* gains, float* decibels, int numValues, float minusInfinityDb, Accuracy accuracy) noexcept
+        {
+            // log10 of 0 is -inf (or -38 for the fast tiers), either way it ends up at minusInfinityDb
+            juce::FloatVectorOperations::max (decibels, gains, 0.0f, numValues);
+            log10 (decibels, decibels, numValues, accuracy);
+            juce::FloatVectorOperations::multiply (decibels, 20.0f, numValues);
+            juce::FloatVectorOperations::max (decibels, decibels, minusInfinityDb, numValues);
+        }
+
+        inline void decibelsToGain (const float* decibels, float* gains, int numValues, float minusInfinityDb, Accuracy accuracy) noexcept
+        {
+            // anything at or below minusInfinityDb is silence, exp2 flushes -inf to 0
+            for (int i = 0; i < numValues; ++i)
+            {
+                const auto dB = decibels[i];
+                gains[i] = dB > minusInfinityDb ? dB * 0.05f : -std::numeric_limits<float>::infinity();
+            }
+            pow10 (gains, gains, numValues, accuracy);
+        }
+    }
+}
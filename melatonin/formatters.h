@@ -0,0 +1,385 @@
+#pragma once
+
+#include <charconv>
+
+// Allocation free versions of the stringFrom* helpers in strings.h
+//
+// Each formatter writes into a caller provided buffer, so painting hundreds of labels doesn't hit the heap:
+//
+//    std::array<char, 32> text;
+//    auto label = melatonin::format<melatonin::formatters::Hz> (frequency, text); // a std::string_view of "1.5 kHz"
+//
+// The output is byte for byte what the juce::String lambdas in strings.h return (those lambdas now call these).
+// Formatting happens in two stages, so that callers can tell when a label would change without rendering it:
+//  * quantize turns the value into exactly what will be displayed (which unit, which digits)
+//  * render writes that out
+//
+// Doubles are formatted as doubles, like juce::String (double, numberOfDecimalPlaces) would.
+// Anything else (such as an int) is formatted as the float it used to be converted to.
+namespace melatonin
+{
+    template <typename T>
+    using FormatFloatType = std::conditional_t<std::is_same_v<T, double> || std::is_same_v<T, long double>, double, float>;
+
+    // A number rounded exactly the way juce::String (float or double, numberOfDecimalPlaces) rounds it
+    struct FixedDecimal
+    {
+        // |value| * 10^decimals, rounded. For whole numbers (decimals == 0) it's just |value|
+        int64_t scaled = 0;
+        int decimals = 0;
+        bool negative = false;
+
+        // juce::String only does its own rounding for 1-6 decimals and values under 1e20.
+        // Anything else (including nan and inf) goes through std::ostream, so we print the original value the same way
+        bool fallback = false;
+        double value = 0.0;
+
+        // juce::String formats floats as doubles too, so this takes either
+        static FixedDecimal fromFloat (double n, int decimalsToUse) noexcept
+        {
+            if (decimalsToUse > 0 && decimalsToUse < 7 && n > -1.0e20 && n < 1.0e20)
+                return { (int64_t) (std::pow (10.0, decimalsToUse) * std::abs (n) + 0.5), decimalsToUse, n < 0, false, n };
+
+            return { 0, decimalsToUse, false, true, n };
+        }
+
+        static FixedDecimal fromInt (int valueToUse) noexcept
+        {
+            return { std::abs ((int64_t) valueToUse), 0, valueToUse < 0, false, (double) valueToUse };
+        }
+
+        bool operator== (const FixedDecimal& other) const noexcept
+        {
+            if (fallback || other.fallback)
+                return fallback == other.fallback && decimals == other.decimals && std::memcmp (&value, &other.value, sizeof (double)) == 0;
+
+            return scaled == other.scaled && decimals == other.decimals && negative == other.negative;
+        }
+
+        bool operator!= (const FixedDecimal& other) const noexcept { return ! (*this == other); }
+    };
+
+    // Everything that decides what a formatter prints
+    // branch is formatter specific, for example ms vs s
+    struct DisplayValue
+    {
+        FixedDecimal number;
+        uint8_t branch = 0;
+
+        bool operator== (const DisplayValue& other) const noexcept { return branch == other.branch && number == other.number; }
+        bool operator!= (const DisplayValue& other) const noexcept { return ! (*this == other); }
+    };
+
+    // Appends to a char buffer, truncating (but always null terminating) when it runs out of room
+    class TextWriter
+    {
+    public:
+        TextWriter (char* destinationToUse, size_t sizeToUse) noexcept
+            : destination (destinationToUse), size (sizeToUse)
+        {
+            jassert (size > 0);
+            destination[0] = 0;
+        }
+
+        void append (const char* text, size_t numChars) noexcept
+        {
+            numChars = std::min (numChars, size - 1 - length);
+            std::memcpy (destination + length, text, numChars);
+            length += numChars;
+            destination[length] = 0;
+        }
+
+        void append (std::string_view text) noexcept { append (text.data(), text.size()); }
+
+        // wholePartOnly matches juce::String::dropLastCharacters (2) on a number with 1 decimal
+        void append (const FixedDecimal& number, bool wholePartOnly = false) noexcept
+        {
+            char text[64];
+            auto numChars = render (number, text, sizeof (text));
+            if (wholePartOnly)
+                numChars = numChars >= 2 ? numChars - 2 : 0;
+            append (text, numChars);
+        }
+
+        [[nodiscard]] size_t getLength() const noexcept { return length; }
+
+    private:
+        char* destination;
+        size_t size;
+        size_t length = 0;
+
+        static size_t render (const FixedDecimal& number, char* text, size_t textSize) noexcept
+        {
+            if (number.fallback)
+            {
+                // what std::ostream does for juce::String (in the classic locale): fixed with the given precision, or its defaults
+                // room for every digit of the biggest double, which fixed prints out in full
+                char wide[400];
+#if __cpp_lib_to_chars >= 201611L
+                const auto result = number.decimals > 0 ? std::to_chars (wide, wide + sizeof (wide), number.value, std::chars_format::fixed, number.decimals)
+                                                        : std::to_chars (wide, wide + sizeof (wide), number.value, std::chars_format::general, 6);
+                const auto written = result.ec == std::errc() ? (size_t) (result.ptr - wide) : 0;
+#else
+                // Some standard libraries (such as older libc++) have no floating point to_chars.
+                // printf follows the host's LC_NUMERIC, but its only locale specific character here is the decimal point
+                const auto printed = number.decimals > 0 ? std::snprintf (wide, sizeof (wide), "%.*f", number.decimals, number.value)
+                                                         : std::snprintf (wide, sizeof (wide), "%g", number.value);
+                const auto written = printed < 0 ? 0 : std::min ((size_t) printed, sizeof (wide) - 1);
+                for (size_t i = 0; i < written; ++i)
+                    if (! std::isalnum ((unsigned char) wide[i]) && wide[i] != '-' && wide[i] != '+')
+                        wide[i] = '.';
+#endif
+                const auto numChars = std::min (written, textSize - 1);
+                std::memcpy (text, wide, numChars);
+                text[numChars] = 0;
+                return numChars;
+            }
+
+            char digits[24];
+            const auto numDigits = (size_t) (std::to_chars (digits, digits + sizeof (digits), number.scaled).ptr - digits);
+            const auto decimals = (size_t) number.decimals;
+
+            size_t length = 0;
+            if (number.negative)
+                text[length++] = '-';
+
+            // Like juce::String, there's always at least one digit before the point
+            const auto numPaddedDigits = decimals > 0 ? std::max (numDigits, decimals + 1) : numDigits;
+            const auto numLeadingZeros = numPaddedDigits - numDigits;
+            for (size_t i = 0; i < numPaddedDigits; ++i)
+            {
+                if (decimals > 0 && i == numPaddedDigits - decimals)
+                    text[length++] = '.';
+
+                text[length++] = i < numLeadingZeros ? '0' : digits[i - numLeadingZeros];
+            }
+
+            text[length] = 0;
+            return length;
+        }
+    };
+
+    // Writes any of the formatters below into a buffer, returning the number of chars written (not counting the null terminator)
+    template <typename Formatter, typename ValueType>
+    static inline size_t format (ValueType value, char* destination, size_t size, int maximumStringLength = Formatter::defaultMaximumStringLength) noexcept
+    {
+        TextWriter text (destination, size);
+        Formatter::render (Formatter::quantize ((FormatFloatType<ValueType>) value, maximumStringLength), text);
+        return text.getLength();
+    }
+
+    template <typename Formatter, typename ValueType, size_t Size>
+    static inline std::string_view format (ValueType value, std::array<char, Size>& destination, int maximumStringLength = Formatter::defaultMaximumStringLength) noexcept
+    {
+        return { destination.data(), format<Formatter> (value, destination.data(), Size, maximumStringLength) };
+    }
+
+    // For the lambdas in strings.h, which have to hand JUCE a juce::String
+    template <typename Formatter, typename ValueType>
+    static inline juce::String formatToString (ValueType value, int maximumStringLength = Formatter::defaultMaximumStringLength)
+    {
+        std::array<char, 64> text;
+        const auto length = format<Formatter> (value, text.data(), text.size(), maximumStringLength);
+        return { text.data(), length };
+    }
+
+    // Each formatter matches the lambda of the same name in strings.h
+    // maximumStringLength is only used by ZeroTo1, the others take it to share a signature
+    // quantize takes a float or a double, the arithmetic happens in that type like it would in the lambda
+    namespace formatters
+    {
+        // stringFromTimeValue
+        struct Time
+        {
+            static constexpr int defaultMaximumStringLength = 5;
+            enum Branch : uint8_t { zero, milliseconds, seconds };
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                if ((value < 0.0) || (value == 0.0))
+                    return { {}, zero };
+
+                // We want 0 number of decimal places for ms values
+                if (value < 0.5)
+                    return { FixedDecimal::fromFloat (value * 1000, 1), milliseconds };
+
+                return { FixedDecimal::fromFloat (value, 2), seconds };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                if (display.branch == zero)
+                    return text.append ("0ms");
+
+                text.append (display.number, display.branch == milliseconds);
+                text.append (display.branch == milliseconds ? "ms" : "s");
+            }
+        };
+
+        // stringFromDBValue, only 1 decimal place
+        struct Decibels
+        {
+            static constexpr int defaultMaximumStringLength = 5;
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                return { FixedDecimal::fromFloat (value, 1) };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                text.append (display.number);
+                text.append ("db");
+            }
+        };
+
+        // stringFromDBValueWithOffAt64
+        struct DecibelsWithOffAt64
+        {
+            static constexpr int defaultMaximumStringLength = 5;
+            enum Branch : uint8_t { decibels, off };
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                if (juce::approximatelyEqual (value, (FloatType) -64))
+                    return { {}, off };
+
+                return Decibels::quantize (value);
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                if (display.branch == off)
+                    return text.append ("OFF");
+
+                Decibels::render (display, text);
+            }
+        };
+
+        // stringFromIntValue
+        struct Int
+        {
+            static constexpr int defaultMaximumStringLength = 5;
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                return { FixedDecimal::fromInt ((int) value) };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                text.append (display.number);
+            }
+        };
+
+        // stringFromPercentValue, whole percentages
+        struct Percent
+        {
+            static constexpr int defaultMaximumStringLength = 0;
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                // juce::String rounds to 1 decimal, then the lambda drops that decimal and the point
+                return { FixedDecimal::fromFloat (value * 100.0f, 1) };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                text.append (display.number, true);
+                text.append ("%");
+            }
+        };
+
+        // stringFromPercentValueWithDigits
+        template <int MaxDigits>
+        struct PercentWithDigits
+        {
+            static constexpr int defaultMaximumStringLength = 0;
+            enum Branch : uint8_t { percent, off };
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                if (juce::approximatelyEqual (value, (FloatType) 0))
+                    return { {}, off };
+
+                return { FixedDecimal::fromFloat (value * 100.0f, MaxDigits) };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                if (display.branch == off)
+                    return text.append ("OFF");
+
+                text.append (display.number);
+                text.append ("%");
+            }
+        };
+
+        // stringFromHzValue
+        struct Hz
+        {
+            static constexpr int defaultMaximumStringLength = 5;
+            enum Branch : uint8_t { kiloHertz, hertz, wholeHertz };
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                if (value >= 1500.f)
+                    return { FixedDecimal::fromFloat (value / 1000.0f, 1), kiloHertz };
+                if (value < 2.0f)
+                    return { FixedDecimal::fromFloat (value, 2), hertz };
+                if (value < 10.0f)
+                    return { FixedDecimal::fromFloat (value, 1), hertz };
+
+                return { FixedDecimal::fromFloat (value, 1), wholeHertz };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                text.append (display.number, display.branch == wholeHertz);
+                text.append (display.branch == kiloHertz ? " kHz" : " Hz");
+            }
+        };
+
+        // stringFromSemiValue
+        struct Semi
+        {
+            static constexpr int defaultMaximumStringLength = 5;
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int = defaultMaximumStringLength) noexcept
+            {
+                return { FixedDecimal::fromInt ((int) value) };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                text.append (display.number);
+                text.append (" semi");
+            }
+        };
+
+        // stringFrom0to1, maximumStringLength is the number of decimal places
+        struct ZeroTo1
+        {
+            static constexpr int defaultMaximumStringLength = 4;
+
+            template <typename FloatType>
+            static DisplayValue quantize (FloatType value, int maximumStringLength = defaultMaximumStringLength) noexcept
+            {
+                return { FixedDecimal::fromFloat (value, maximumStringLength) };
+            }
+
+            static void render (const DisplayValue& display, TextWriter& text) noexcept
+            {
+                text.append (display.number);
+            }
+        };
+    }
+}
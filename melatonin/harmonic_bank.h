@@ -0,0 +1,105 @@
+#pragma once
+
+// A whole bank of decibelRangeForHarmonic ranges, converted in one pass
+//
+// An additive synth with one decibelRangeForHarmonic per harmonic pays a std::function call and a juce::Decibels call
+// for every harmonic, every block. HarmonicBank keeps each harmonic's number, minimum dB and normalized value
+// in contiguous arrays, so all of them convert in a handful of vector operations:
+//
+//    melatonin::HarmonicBank harmonics (256);
+//    harmonics.setNormalized (0, 1.0f);          // the fundamental at full gain
+//    harmonics.gainFrom0to1 (gains.data());      // one gain per harmonic, ready for the oscillators
+//
+// Harmonic i is harmonic number i + 1. The conversions match decibelRangeForHarmonic (i + 1, minimum),
+// including the clamp to 1 in convertTo0to1, which is what getRange hands to the APVTS.
+// Everything is allocated at construction, nothing after.
+namespace melatonin
+{
+    class HarmonicBank
+    {
+    public:
+        explicit HarmonicBank (size_t numHarmonics, float minimum = -100.f, Accuracy accuracyToUse = Accuracy::exact)
+            : harmonicNumbers (numHarmonics), inverseHarmonicNumbers (numHarmonics),
+              minimums (numHarmonics, minimum), minimumGains (numHarmonics, juce::Decibels::decibelsToGain (minimum, minimum - 1.0f)),
+              normalized (numHarmonics, 0.0f), accuracy (accuracyToUse)
+        {
+            jassert (minimum < 0.0f);
+            for (size_t i = 0; i < numHarmonics; ++i)
+            {
+                harmonicNumbers[i] = (float) (i + 1);
+                inverseHarmonicNumbers[i] = 1.0f / harmonicNumbers[i];
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return normalized.size(); }
+
+        void setMinimum (size_t index, float minimum) noexcept
+        {
+            jassert (minimum < 0.0f);
+            minimums[index] = minimum;
+            minimumGains[index] = juce::Decibels::decibelsToGain (minimum, minimum - 1.0f);
+        }
+
+        [[nodiscard]] float getMinimum (size_t index) const noexcept { return minimums[index]; }
+
+        void setNormalized (size_t index, float value) noexcept { normalized[index] = value; }
+        [[nodiscard]] float getNormalized (size_t index) const noexcept { return normalized[index]; }
+
+        // Fill these straight from the parameters, one per harmonic
+        [[nodiscard]] float* getNormalizedValues() noexcept { return normalized.data(); }
+        [[nodiscard]] const float* getNormalizedValues() const noexcept { return normalized.data(); }
+
+        // Every harmonic's dB, same as decibelRangeForHarmonic's convertFrom0to1
+        void convertFrom0to1 (float* decibels) const noexcept
+        {
+            clippedGains (decibels);
+
+            // log10 of 0 is -inf (or -38 for the fast tiers), either way it ends up at the minimum
+            fastmath::log10 (decibels, decibels, numValues(), accuracy);
+            juce::FloatVectorOperations::multiply (decibels, 20.0f, numValues());
+            juce::FloatVectorOperations::max (decibels, decibels, minimums.data(), numValues());
+        }
+
+        // Every harmonic's linear gain, same as juce::Decibels::decibelsToGain on the dB above, without the round trip
+        void gainFrom0to1 (float* gains) const noexcept
+        {
+            clippedGains (gains);
+
+            // at or below the minimum is silence
+            for (size_t i = 0; i < size(); ++i)
+                gains[i] = gains[i] > minimumGains[i] ? gains[i] : 0.0f;
+        }
+
+        // Sets every harmonic from its dB, same as decibelRangeForHarmonic's convertTo0to1
+        void convertTo0to1 (const float* decibels) noexcept
+        {
+            for (size_t i = 0; i < size(); ++i)
+                normalized[i] = decibels[i] > minimums[i] ? decibels[i] * 0.05f : -std::numeric_limits<float>::infinity();
+            fastmath::pow10 (normalized.data(), normalized.data(), numValues(), accuracy);
+            juce::FloatVectorOperations::multiply (normalized.data(), harmonicNumbers.data(), numValues());
+
+            // this can sometimes result in a number just barely above 1.0f
+            juce::FloatVectorOperations::clip (normalized.data(), normalized.data(), 0.0f, 1.0f, numValues());
+        }
+
+        // The matching range for one harmonic's parameter
+        [[nodiscard]] juce::NormalisableRange<float> getRange (size_t index) const
+        {
+            return decibelRangeForHarmonic (index + 1, minimums[index], accuracy);
+        }
+
+    private:
+        std::vector<float> harmonicNumbers, inverseHarmonicNumbers;
+        std::vector<float> minimums, minimumGains;
+        std::vector<float> normalized;
+        Accuracy accuracy;
+
+        [[nodiscard]] int numValues() const noexcept { return (int) normalized.size(); }
+
+        void clippedGains (float* gains) const noexcept
+        {
+            juce::FloatVectorOperations::clip (gains, normalized.data(), 0.0f, 1.0f, numValues());
+            juce::FloatVectorOperations::multiply (gains, inverseHarmonicNumbers.data(), numValues());
+        }
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+// Every label and tick position of a stepped range, worked out once
+//
+// A range with an interval (like intRangeWithMidPoint, or a 48 step semitone range) only has so many legal values,
+// so all of their text can be formatted up front. After that, a label or a normalized position is a table index:
+// no formatting and no convertTo0to1 for host getText polling, combo boxes, or tick marks.
+//
+//    const melatonin::LabelTable semitones (juce::NormalisableRange<float> (-24.0f, 24.0f, 1.0f), stringFromSemiValue);
+//    comboBox.addItemList (semitones.getLabels(), 1);
+//    auto x = semitones.getNormalized (i) * width;
+//
+// For juce::AudioParameterFloat, labelledStringFrom is a drop in replacement for the stringFrom* lambda.
+// Values between legal values get the label of the legal value they'd snap to.
+namespace melatonin
+{
+    class LabelTable
+    {
+    public:
+        // Any of the stringFrom* lambdas in strings.h, or anything else taking a value and returning a juce::String
+        template <typename StringFromValue>
+        LabelTable (const juce::NormalisableRange<float>& range, StringFromValue&& stringFromValue)
+            : start (range.start), interval (range.interval)
+        {
+            // Only ranges with an interval have a known set of legal values
+            jassert (interval > 0);
+            if (interval <= 0)
+                interval = range.end - range.start;
+
+            // The legal values are the steps from start. An end that isn't on a step snaps down to the last one,
+            // and the last step can land a hair over the end in floats, which is then just the end
+            const auto numValues = (int) std::floor ((range.end - range.start) / interval + 0.001f) + 1;
+
+            // This is meant for ranges with tens or hundreds of values, not an interval of 0.0001
+            jassert (numValues <= 4096);
+
+            values.reserve ((size_t) numValues);
+            normalized.reserve ((size_t) numValues);
+            labels.ensureStorageAllocated (numValues);
+            for (int i = 0; i < numValues; ++i)
+            {
+                const auto value = range.snapToLegalValue (juce::jmin (range.start + (float) i * interval, range.end));
+                values.push_back (value);
+                normalized.push_back (range.convertTo0to1 (value));
+                labels.add (stringFromValue (value));
+            }
+        }
+
+        [[nodiscard]] size_t size() const noexcept { return values.size(); }
+
+        [[nodiscard]] float getValue (size_t index) const noexcept { return values[index]; }
+        [[nodiscard]] float getNormalized (size_t index) const noexcept { return normalized[index]; }
+        [[nodiscard]] const juce::String& getLabel (size_t index) const noexcept { return labels[(int) index]; }
+
+        // In order, ready for a juce::ComboBox
+        [[nodiscard]] const juce::StringArray& getLabels() const noexcept { return labels; }
+
+        // The legal value nearest to value, rounded and clamped the way NormalisableRange snaps
+        [[nodiscard]] size_t indexOf (float value) const noexcept
+        {
+            // clamped as a float, so NaN (which fails every comparison) and huge values never reach the cast
+            const auto index = std::floor ((value - start) / interval + 0.5f);
+            return ! (index > 0) ? 0 : (size_t) std::min (index, (float) (values.size() - 1));
+        }
+
+        // The legal value nearest to a normalized position, halfway goes to the higher one
+        [[nodiscard]] size_t indexOfNormalized (float position) const noexcept
+        {
+            const auto above = (size_t) (std::lower_bound (normalized.begin(), normalized.end(), position) - normalized.begin());
+            if (above == 0)
+                return 0;
+            if (above == normalized.size())
+                return above - 1;
+
+            return position - normalized[above - 1] < normalized[above] - position ? above - 1 : above;
+        }
+
+        [[nodiscard]] const juce::String& labelFor (float value) const noexcept { return getLabel (indexOf (value)); }
+        [[nodiscard]] const juce::String& labelForNormalized (float position) const noexcept { return getLabel (indexOfNormalized (position)); }
+
+    private:
+        float start;
+        float interval;
+        std::vector<float> values;
+        std::vector<float> normalized;
+        juce::StringArray labels;
+    };
+
+    // A drop in replacement for a stringFrom* lambda on a stepped range, with every label formatted up front
+    //
+    //    juce::AudioParameterFloat ("transpose", "Transpose", range, 0.0f, juce::String(),
+    //        juce::AudioProcessorParameter::genericParameter, melatonin::labelledStringFrom (range, stringFromSemiValue), semiValueFromString)
+    template <typename StringFromValue>
+    static inline auto labelledStringFrom (const juce::NormalisableRange<float>& range, StringFromValue&& stringFromValue)
+    {
+        return [table = std::make_shared<const LabelTable> (range, std::forward<StringFromValue> (stringFromValue))] (float value, [[maybe_unused]] int maximumStringLength = 5) {
+            return table->labelFor (value);
+        };
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+// Bakes any range into a pair of fixed size tables, one for each direction
+//
+// The log and decibel ranges call exp2, log2, pow or log10 on every conversion.
+// A table of NumPoints floats stays in cache, so per-sample modulation of lots of parameters gets affordable.
+//
+//    auto release = melatonin::LookupTableRange<1024> (logarithmicRange (0.0f, 15.0f));
+//    jassert (release.getFrom0to1Error().maxAbsolute < 0.001f);
+//
+// The cost is accuracy. Construction measures the worst error of each table against the exact range
+// by checking several points between every pair of table entries, so you can decide if it's good enough.
+// It's a measurement rather than a proof, so elsewhere the error can be off by a few floats of rounding.
+// Expect the to0to1 direction of steep log ranges to be the worst, as the curve bends hardest near the start.
+namespace melatonin
+{
+    enum class Interpolation {
+        linear,
+        cubic // Catmull-Rom, more accurate on smooth curves
+    };
+
+    struct LookupTableError
+    {
+        float maxAbsolute = 0.0f;
+
+        // relative to the exact value, ignoring spots where the exact value is 0
+        float maxRelative = 0.0f;
+    };
+
+    template <size_t NumPoints = 1024>
+    class LookupTableRange
+    {
+    public:
+        static_assert (NumPoints >= 4, "Need at least 4 points to interpolate");
+
+        explicit LookupTableRange (const juce::NormalisableRange<float>& exactRange, Interpolation interpolationToUse = Interpolation::linear)
+            : start (exactRange.start), end (exactRange.end), inverseLength (1.0f / (exactRange.end - exactRange.start)), interpolation (interpolationToUse)
+        {
+            fillTable (from0to1Table, [&] (float x) { return exactRange.convertFrom0to1 (x); });
+            fillTable (to0to1Table, [&] (float x) { return exactRange.convertTo0to1 (start + x * (end - start)); });
+
+            from0to1Error = measureError ([&] (float x) { return exactRange.convertFrom0to1 (x); },
+                [this] (float x) { return convertFrom0to1 (x); });
+
+            to0to1Error = measureError ([&] (float x) { return exactRange.convertTo0to1 (start + x * (end - start)); },
+                [this] (float x) { return convertTo0to1 (start + x * (end - start)); });
+        }
+
+        [[nodiscard]] float convertFrom0to1 (float normalized) const noexcept
+        {
+            return lookup (from0to1Table, normalized);
+        }
+
+        [[nodiscard]] float convertTo0to1 (float unnormalized) const noexcept
+        {
+            return std::clamp (lookup (to0to1Table, (unnormalized - start) * inverseLength), 0.0f, 1.0f);
+        }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            lookup (from0to1Table, normalized, unnormalized, numValues, 0.0f, 1.0f);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            lookup (to0to1Table, unnormalized, normalized, numValues, start, inverseLength);
+            juce::FloatVectorOperations::clip (normalized, normalized, 0.0f, 1.0f, numValues);
+        }
+
+        [[nodiscard]] const LookupTableError& getFrom0to1Error() const noexcept { return from0to1Error; }
+        [[nodiscard]] const LookupTableError& getTo0to1Error() const noexcept { return to0to1Error; }
+
+        [[nodiscard]] float getStart() const noexcept { return start; }
+        [[nodiscard]] float getEnd() const noexcept { return end; }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+    private:
+        // One extra point on each side lets cubic interpolation read 4 points without bounds checks
+        using Table = std::array<float, NumPoints + 2>;
+        Table from0to1Table {}, to0to1Table {};
+
+        float start, end, inverseLength;
+        Interpolation interpolation;
+        LookupTableError from0to1Error, to0to1Error;
+
+        static constexpr float lastIndex = (float) (NumPoints - 1);
+
+        template <typename Function>
+        static void fillTable (Table& table, Function&& exact)
+        {
+            for (size_t i = 0; i < NumPoints; ++i)
+                table[i + 1] = exact ((float) i / lastIndex);
+
+            // extrapolate the edges with a cubic through the last 4 points,
+            // so the first and last interval keep cubic accuracy
+            table[0] = 4.0f * table[1] - 6.0f * table[2] + 4.0f * table[3] - table[4];
+            table[NumPoints + 1] = 4.0f * table[NumPoints] - 6.0f * table[NumPoints - 1] + 4.0f * table[NumPoints - 2] - table[NumPoints - 3];
+        }
+
+        // Where proportion lands in the table: the index of the point before it, and how far along to the next one
+        // The clamp is written so NaN ends up at 0 (any comparison with NaN is false), instead of being cast to an index
+        template <typename Vec>
+        static void findPosition (Vec proportion, int32_t* index, float* fraction) noexcept
+        {
+            const auto zero = simd::broadcast<Vec> (0.0f), one = simd::broadcast<Vec> (1.0f);
+            proportion = simd::select (simd::isBelow (zero, proportion), proportion, zero);
+            proportion = simd::select (simd::isBelow (proportion, one), proportion, one);
+
+            const auto position = simd::mul (proportion, simd::broadcast<Vec> (lastIndex));
+            const auto whole = simd::min (simd::toFloat (simd::truncateToInt (position)), simd::broadcast<Vec> ((float) (NumPoints - 2)));
+            simd::store (index, simd::truncateToInt (whole));
+            simd::store (fraction, simd::sub (position, whole));
+        }
+
+        [[nodiscard]] float lookup (const Table& table, float proportion) const noexcept
+        {
+            int32_t index;
+            float fraction;
+            findPosition (proportion, &index, &fraction);
+            return interpolate (table, (size_t) index, fraction);
+        }
+
+        // The positions of a chunk are found 4 at a time, then each value reads its points from the table
+        // proportion is (value - offset) * scale
+        void lookup (const Table& table, const float* source, float* destination, int numValues, float offset, float scale) const noexcept
+        {
+            constexpr int chunkSize = 64;
+            int32_t indices[chunkSize];
+            float fractions[chunkSize];
+
+            for (int chunkStart = 0; chunkStart < numValues; chunkStart += chunkSize)
+            {
+                const auto numInChunk = std::min (chunkSize, numValues - chunkStart);
+                const auto* values = source + chunkStart;
+
+                int i = 0;
+#if MELATONIN_SIMD
+                for (; i + 4 <= numInChunk; i += 4)
+                    findPosition (simd::mul (simd::sub (simd::load (values + i), simd::broadcast<simd::Float4> (offset)), simd::broadcast<simd::Float4> (scale)), indices + i, fractions + i);
+#endif
+                for (; i < numInChunk; ++i)
+                    findPosition ((values[i] - offset) * scale, indices + i, fractions + i);
+
+                for (i = 0; i < numInChunk; ++i)
+                    destination[chunkStart + i] = interpolate (table, (size_t) indices[i], fractions[i]);
+            }
+        }
+
+        [[nodiscard]] float interpolate (const Table& table, size_t index, float fraction) const noexcept
+        {
+            // table is offset by one, so p1 is the point at index
+            const auto p1 = table[index + 1];
+            const auto p2 = table[index + 2];
+
+            if (interpolation == Interpolation::linear)
+                return p1 + fraction * (p2 - p1);
+
+            const auto p0 = table[index];
+            const auto p3 = table[index + 3];
+            return p1 + 0.5f * fraction * (p2 - p0 + fraction * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3 + fraction * (3.0f * (p1 - p2) + p3 - p0)));
+        }
+
+        template <typename Exact, typename Approximate>
+        static LookupTableError measureError (Exact&& exact, Approximate&& approximate)
+        {
+            constexpr int pointsBetweenEntries = 8;
+            constexpr auto numChecks = (NumPoints - 1) * pointsBetweenEntries;
+
+            LookupTableError error;
+            for (size_t i = 0; i <= numChecks; ++i)
+            {
+                const auto x = (float) i / (float) numChecks;
+                const auto expected = exact (x);
+                const auto difference = std::abs (approximate (x) - expected);
+
+                error.maxAbsolute = std::max (error.maxAbsolute, difference);
+                if (expected != 0.0f)
+                    error.maxRelative = std::max (error.maxRelative, difference / std::abs (expected));
+            }
+            return error;
+        }
+    };
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+// Morphs between presets in the normalized domain, then converts everything to plain values in blocks
+//
+// Blending plain values puts the middle of a morph between 20Hz and 20kHz at 10kHz, which sounds almost all the way there.
+// Blending normalized values moves the way the knobs would, so log and decibel ranges morph evenly to the ear.
+// Stepped parameters (like intRangeWithMidPoint) don't blend, they take the value of whichever snapshot has the most weight.
+//
+//    melatonin::MorphEngine<> morph;
+//    morph.addParameters (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f), 8); // 8 band frequencies
+//    morph.addParameters (melatonin::CompactRange::intWithMidPoint (1, 8, 4));       // voices, stepped
+//    for (auto& preset : corners)
+//        morph.addSnapshot (preset.normalizedValues.data());
+//
+//    // once per block
+//    morph.processXY (x, y, plainValues);
+//
+// Parameters are stored in the order they're added, so ranges shared by a run of parameters convert as one block.
+// RangeType can be any range from this module, CompactRange (the default) holds any of them in one array.
+//
+// Adding parameters and snapshots allocates, processing doesn't, so process can run on the audio thread
+// (as long as snapshots aren't being added from another thread at the same time).
+namespace melatonin
+{
+    enum class MorphMode {
+        automatic, // stepped for intWithMidPoint ranges, or any juce::NormalisableRange with an interval
+        blend,
+        stepped
+    };
+
+    template <typename RangeType>
+    static inline bool isStepped (const RangeType& range) noexcept
+    {
+        if constexpr (std::is_same_v<RangeType, CompactRange>)
+            return range.getKind() == CompactRange::Kind::intWithMidPoint;
+        else if constexpr (std::is_same_v<RangeType, IntRangeWithMidPoint>)
+            return true;
+        else if constexpr (std::is_same_v<RangeType, juce::NormalisableRange<float>>)
+            return range.interval > 0;
+        else
+            return false;
+    }
+
+    template <typename RangeType = CompactRange>
+    class MorphEngine
+    {
+    public:
+        // Adds numParameters in a row that share a range, returns the index of the first one
+        // All the parameters have to be added before the first snapshot
+        int addParameters (const RangeType& range, int numParameters = 1, MorphMode mode = MorphMode::automatic)
+        {
+            jassert (numSnapshots == 0 && numParameters > 0);
+
+            const auto first = getNumParameters();
+            const auto stepped = mode == MorphMode::stepped || (mode == MorphMode::automatic && isStepped (range));
+
+            // a run can be extended when the range is the same, which is common for banks of bands or harmonics
+            if (! groups.empty() && groups.back().stepped == stepped && sameRange (groups.back().range, range))
+                groups.back().numParameters += numParameters;
+            else
+                groups.push_back ({ range, first, numParameters, stepped });
+
+            normalized.resize ((size_t) (first + numParameters));
+            return first;
+        }
+
+        // One normalized value for every parameter, in the order they were added
+        int addSnapshot (const float* snapshotValues)
+        {
+            snapshots.insert (snapshots.end(), snapshotValues, snapshotValues + getNumParameters());
+            weights.resize ((size_t) ++numSnapshots);
+            return numSnapshots - 1;
+        }
+
+        // A preset from a bank, with the same parameters in the same order
+        int addSnapshot (const SnapshotView& bank, int preset)
+        {
+            jassert (bank.getNumParameters() == getNumParameters());
+            snapshots.resize (snapshots.size() + normalized.size());
+            weights.resize ((size_t) ++numSnapshots);
+            bank.getNormalized (preset, 0, getNumParameters(), snapshotData (numSnapshots - 1));
+            return numSnapshots - 1;
+        }
+
+        // Replaces a snapshot without allocating
+        void setSnapshot (int snapshot, const float* snapshotValues) noexcept
+        {
+            jassert (juce::isPositiveAndBelow (snapshot, numSnapshots));
+            std::copy (snapshotValues, snapshotValues + getNumParameters(), snapshotData (snapshot));
+        }
+
+        [[nodiscard]] int getNumParameters() const noexcept { return (int) normalized.size(); }
+        [[nodiscard]] int getNumSnapshots() const noexcept { return numSnapshots; }
+
+        // The normalized values of the last morph, for updating the parameters themselves
+        [[nodiscard]] const float* getNormalized() const noexcept { return normalized.data(); }
+
+        // Any blend of the snapshots, one weight each. Weights don't have to add up to 1
+        void process (const float* snapshotWeights, float* plainValues) noexcept
+        {
+            // nothing to morph between, so plainValues are left as they are
+            if (numSnapshots == 0)
+            {
+                jassertfalse;
+                return;
+            }
+
+            const auto numParameters = getNumParameters();
+
+            auto totalWeight = 0.0f;
+            int heaviest = 0;
+            for (int i = 0; i < numSnapshots; ++i)
+            {
+                jassert (snapshotWeights[i] >= 0);
+                totalWeight += snapshotWeights[i];
+                if (snapshotWeights[i] > snapshotWeights[heaviest])
+                    heaviest = i;
+            }
+
+            if (totalWeight <= 0)
+            {
+                jassertfalse;
+                std::copy (snapshotData (0), snapshotData (0) + numParameters, normalized.data());
+            }
+            else
+            {
+                // a weighted sum, skipping the snapshots that have no say (most of them, on an XY pad between 4 corners)
+                bool first = true;
+                for (int i = 0; i < numSnapshots; ++i)
+                {
+                    if (snapshotWeights[i] <= 0)
+                        continue;
+
+                    const auto weight = snapshotWeights[i] / totalWeight;
+                    if (first)
+                        juce::FloatVectorOperations::multiply (normalized.data(), snapshotData (i), weight, numParameters);
+                    else
+                        juce::FloatVectorOperations::addWithMultiply (normalized.data(), snapshotData (i), weight, numParameters);
+                    first = false;
+                }
+            }
+
+            for (const auto& group : groups)
+            {
+                auto* groupNormalized = normalized.data() + group.firstParameter;
+                if (group.stepped)
+                    std::copy (snapshotData (heaviest) + group.firstParameter, snapshotData (heaviest) + group.firstParameter + group.numParameters, groupNormalized);
+
+                melatonin::convertFrom0to1 (group.range, groupNormalized, plainValues + group.firstParameter, group.numParameters);
+            }
+        }
+
+        // Along the snapshots in order: 0 is the first one, 1 is the last, and each pair is an equal share in between
+        // Stepped parameters switch halfway between neighbors
+        void process (float position, float* plainValues) noexcept
+        {
+            if (numSnapshots == 0)
+            {
+                jassertfalse;
+                return;
+            }
+
+            std::fill (weights.begin(), weights.end(), 0.0f);
+
+            const auto scaled = std::clamp (position, 0.0f, 1.0f) * (float) (numSnapshots - 1);
+            const auto lower = std::min ((int) scaled, numSnapshots - 1);
+            const auto amount = scaled - (float) lower;
+            weights[(size_t) lower] = 1.0f - amount;
+            if (amount > 0)
+                weights[(size_t) lower + 1] = amount;
+
+            process (weights.data(), plainValues);
+        }
+
+        // Between 4 snapshots at the corners of an XY pad, in the order (0, 0), (1, 0), (0, 1), (1, 1)
+        // With fewer than 4 snapshots, the first one is all there is
+        void processXY (float x, float y, float* plainValues) noexcept
+        {
+            jassert (numSnapshots == 4);
+            if (numSnapshots < 4)
+                return process (0.0f, plainValues);
+
+            x = std::clamp (x, 0.0f, 1.0f);
+            y = std::clamp (y, 0.0f, 1.0f);
+
+            weights[0] = (1.0f - x) * (1.0f - y);
+            weights[1] = x * (1.0f - y);
+            weights[2] = (1.0f - x) * y;
+            weights[3] = x * y;
+            process (weights.data(), plainValues);
+        }
+
+    private:
+        struct Group
+        {
+            RangeType range;
+            int firstParameter;
+            int numParameters;
+            bool stepped;
+        };
+
+        std::vector<Group> groups;
+        std::vector<float> snapshots; // one row of normalized values per snapshot
+        std::vector<float> normalized;
+        std::vector<float> weights;
+        int numSnapshots = 0;
+
+        float* snapshotData (int snapshot) noexcept { return snapshots.data() + (size_t) snapshot * normalized.size(); }
+
+        static bool sameRange (const RangeType& a, const RangeType& b) noexcept
+        {
+            if constexpr (std::is_same_v<RangeType, CompactRange>)
+                return a == b;
+            else
+                return false;
+        }
+    };
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+// The normalized values of a whole parameter layout in one array, passed between two threads without locks
+//
+// Reading hundreds of std::atomic<float>* from an APVTS means a cache miss per parameter, each followed by its own range conversion.
+// A ParameterStore keeps every value in one cache-aligned array, and hands over the whole array at once with triple buffering:
+// the writer always has a buffer of its own, the reader always has a consistent one, and neither ever waits or retries.
+//
+//    melatonin::ParameterStore<> store;
+//    store.addParameters (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f), 8); // 8 band frequencies
+//    store.addParameters (melatonin::CompactRange::decibels (-60.0f, 6.0f), 8);      // 8 band gains
+//
+//    // writer (a preset loader, a morph, the message thread)
+//    store.setNormalized (3, 0.5f);
+//    store.publish();
+//
+//    // reader, once per block
+//    store.readPlainValues (plainValues); // the latest published values, through each range's block conversion
+//
+// There's exactly one writer thread and one reader thread, they can be either the audio thread or not.
+// For several readers, use a store per reader.
+//
+// Adding parameters allocates (and resets every value to 0), so the layout has to be done before the threads start.
+// Publishing and reading don't allocate.
+namespace melatonin
+{
+    template <typename RangeType = CompactRange>
+    class ParameterStore
+    {
+    public:
+        // Adds numParameters in a row that share a range, returns the index of the first one
+        int addParameters (const RangeType& range, int numParameters = 1)
+        {
+            jassert (numParameters > 0);
+
+            const auto first = numParametersInLayout;
+            groups.push_back ({ range, first, numParameters });
+            numParametersInLayout += numParameters;
+
+            // each buffer starts on its own cache line, so the writer and reader never share one
+            stride = (size_t) (numParametersInLayout + valuesPerLine - 1) / valuesPerLine * valuesPerLine;
+            storage.assign (stride * 3 + valuesPerLine, 0.0f);
+            const auto misalignment = reinterpret_cast<uintptr_t> (storage.data()) % cacheLineSize;
+            alignedStart = (misalignment == 0 ? 0 : (cacheLineSize - misalignment) / sizeof (float));
+            return first;
+        }
+
+        [[nodiscard]] int getNumParameters() const noexcept { return numParametersInLayout; }
+
+        // writer
+
+        void setNormalized (int parameter, float normalized) noexcept
+        {
+            jassert (juce::isPositiveAndBelow (parameter, numParametersInLayout));
+            buffer (writeIndex)[parameter] = normalized;
+        }
+
+        // One normalized value for every parameter, in the order they were added
+        void setNormalized (const float* normalized) noexcept
+        {
+            std::copy (normalized, normalized + numParametersInLayout, buffer (writeIndex));
+        }
+
+        // For writing the whole layout in place (from a MorphEngine, or a SnapshotView)
+        // Holds everything set since the last publish, on top of what was published
+        [[nodiscard]] float* getWriteBuffer() noexcept { return buffer (writeIndex); }
+
+        // Makes everything set so far visible to the reader's next read
+        void publish() noexcept
+        {
+            const auto published = writeIndex;
+            writeIndex = middle.exchange (published | freshBit, std::memory_order_acq_rel) & indexMask;
+
+            // the reader only ever reads, so the published values can be copied from while it has them
+            // this keeps the next write on top of the latest values rather than ones from two publishes ago
+            std::copy (buffer (published), buffer (published) + numParametersInLayout, buffer (writeIndex));
+        }
+
+        // reader
+
+        [[nodiscard]] bool hasUpdate() const noexcept { return middle.load (std::memory_order_relaxed) & freshBit; }
+
+        // The latest published normalized values
+        // They won't change until the next call to read, even when the writer publishes in the meantime
+        const float* read() noexcept
+        {
+            if (hasUpdate())
+                readIndex = middle.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+
+            return buffer (readIndex);
+        }
+
+        // Reads, then converts everything, one block per run of parameters added together
+        void readPlainValues (float* plainValues) noexcept
+        {
+            const auto* normalized = read();
+            for (const auto& group : groups)
+                melatonin::convertFrom0to1 (group.range, normalized + group.firstParameter, plainValues + group.firstParameter, group.numParameters);
+        }
+
+        // One value from the last read, converted on demand
+        [[nodiscard]] float getPlainValue (int parameter) const noexcept
+        {
+            jassert (juce::isPositiveAndBelow (parameter, numParametersInLayout));
+            const auto group = std::upper_bound (groups.begin(), groups.end(), parameter, [] (int p, const Group& g) { return p < g.firstParameter; }) - 1;
+            return group->range.convertFrom0to1 (buffer (readIndex)[parameter]);
+        }
+
+    private:
+        struct Group
+        {
+            RangeType range;
+            int firstParameter;
+            int numParameters;
+        };
+
+        static constexpr size_t cacheLineSize = 64;
+        static constexpr int valuesPerLine = (int) (cacheLineSize / sizeof (float));
+
+        static constexpr int indexMask = 3;
+        static constexpr int freshBit = 4;
+
+        std::vector<Group> groups;
+        std::vector<float> storage; // 3 buffers of stride values each, from alignedStart
+        size_t stride = 0;
+        size_t alignedStart = 0;
+        int numParametersInLayout = 0;
+
+        // the buffer that's neither being written nor read, plus whether it's newer than what the reader has
+        alignas (cacheLineSize) std::atomic<int> middle { 1 };
+        alignas (cacheLineSize) int writeIndex = 0; // only touched by the writer
+        alignas (cacheLineSize) int readIndex = 2; // only touched by the reader
+
+        float* buffer (int index) noexcept { return storage.data() + alignedStart + (size_t) index * stride; }
+        const float* buffer (int index) const noexcept { return storage.data() + alignedStart + (size_t) index * stride; }
+    };
+}
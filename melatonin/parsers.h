@@ -0,0 +1,629 @@
+#pragma once
+
+#include <cctype>
+#include <charconv>
+#include <string_view>
+
+// Allocation free versions of the *FromString helpers in strings.h
+//
+// They read straight from a std::string_view, so bulk importing presets or automation doesn't make
+// a juce::String copy for every toLowerCase or dropLastCharacters:
+//
+//    auto seconds = melatonin::parsers::timeValue ("250ms"); // 0.25f
+//
+// Numbers are read like juce::String::getFloatValue and getIntValue: leading whitespace is skipped,
+// as much of a number as possible is read and anything after it is ignored. No number gives 0.
+// Unit suffixes match regardless of case, otherwise the rules are the same as the lambdas (which now call these).
+// Each one returns a float by default, ask for a double with melatonin::parsers::timeValue<double> (text).
+namespace melatonin::parsers
+{
+    static inline std::string_view toStringView (const juce::String& text) noexcept
+    {
+        return { text.toRawUTF8(), text.getNumBytesAsUTF8() };
+    }
+
+    // same as juce::CharacterFunctions::isWhitespace
+    static inline bool isWhitespace (char c) noexcept
+    {
+        return c == ' ' || (c <= 13 && c >= 9);
+    }
+
+    static inline std::string_view trimStart (std::string_view text) noexcept
+    {
+        while (! text.empty() && isWhitespace (text.front()))
+            text.remove_prefix (1);
+        return text;
+    }
+
+    static inline bool equalsIgnoreCase (std::string_view text, std::string_view other) noexcept
+    {
+        if (text.size() != other.size())
+            return false;
+
+        // ASCII only, std::tolower depends on the locale (in Turkish, I doesn't lower to i)
+        auto toLower = [] (char c) { return c >= 'A' && c <= 'Z' ? (char) (c - 'A' + 'a') : c; };
+        for (size_t i = 0; i < text.size(); ++i)
+            if (toLower (text[i]) != toLower (other[i]))
+                return false;
+
+        return true;
+    }
+
+    static inline bool endsWithIgnoreCase (std::string_view text, std::string_view suffix) noexcept
+    {
+        return text.size() >= suffix.size() && equalsIgnoreCase (text.substr (text.size() - suffix.size()), suffix);
+    }
+
+    static inline std::string_view dropLastCharacters (std::string_view text, size_t numChars) noexcept
+    {
+        return text.substr (0, text.size() - std::min (numChars, text.size()));
+    }
+
+    // What strtod (and so juce) gives for a number too big or too small for a double: +-inf or +-0
+    // from_chars leaves the value alone instead, so this works out which way it went from the digits and the exponent
+    static inline double outOfRangeValue (std::string_view number) noexcept
+    {
+        const bool isNegative = ! number.empty() && number.front() == '-';
+        if (! number.empty() && (number.front() == '-' || number.front() == '+'))
+            number.remove_prefix (1);
+
+        // the power of ten of the first significant digit, give or take one (which doesn't matter this far out)
+        auto isDigitAt = [&] (size_t index) { return index < number.size() && number[index] >= '0' && number[index] <= '9'; };
+        int magnitude = 0;
+        size_t i = 0;
+        for (; isDigitAt (i); ++i)
+            if (magnitude > 0 || number[i] != '0')
+                ++magnitude;
+
+        // no significant digits before the point, so each zero after it is another power of ten down
+        if (i < number.size() && number[i] == '.')
+        {
+            ++i;
+            if (magnitude == 0)
+                for (; i < number.size() && number[i] == '0'; ++i)
+                    --magnitude;
+            while (isDigitAt (i))
+                ++i;
+        }
+
+        int exponent = 0;
+        if (i < number.size() && (number[i] == 'e' || number[i] == 'E'))
+        {
+            const bool isExponentNegative = i + 1 < number.size() && number[i + 1] == '-';
+            i += (i + 1 < number.size() && (number[i + 1] == '-' || number[i + 1] == '+')) ? 2 : 1;
+            for (; isDigitAt (i); ++i)
+                exponent = std::min (exponent * 10 + (number[i] - '0'), 100000);
+            if (isExponentNegative)
+                exponent = -exponent;
+        }
+
+        const auto value = magnitude + exponent > 0 ? std::numeric_limits<double>::infinity() : 0.0;
+        return isNegative ? -value : value;
+    }
+
+    // Reads a decimal number (or inf, or nan) like from_chars does, for standard libraries without a floating point one
+    // It's a plain digit loop rather than strtod, so the locale can't turn the decimal point into a comma.
+    // The result is correctly rounded when there are at most 15 or so significant digits and a power of ten up to 22,
+    // which covers anything a preset would hold. Past that it's within an ulp or so.
+    static inline double readDecimal (std::string_view text) noexcept
+    {
+        size_t i = 0;
+        const bool isNegative = ! text.empty() && text[0] == '-';
+        if (isNegative)
+            ++i;
+
+        auto sign = [&] (double value) { return isNegative ? -value : value; };
+        auto startsWith = [&] (std::string_view word) {
+            return text.size() - i >= word.size() && equalsIgnoreCase (text.substr (i, word.size()), word);
+        };
+
+        if (startsWith ("inf"))
+            return sign (std::numeric_limits<double>::infinity());
+        if (startsWith ("nan"))
+            return sign (std::numeric_limits<double>::quiet_NaN());
+
+        // the first 19 significant digits fit in a uint64_t, the rest only move the decimal point
+        uint64_t mantissa = 0;
+        int exponent = 0, numSignificant = 0;
+        bool hasDigits = false, hasDecimalPoint = false;
+        for (; i < text.size(); ++i)
+        {
+            const auto c = text[i];
+            if (c == '.' && ! hasDecimalPoint)
+            {
+                hasDecimalPoint = true;
+                continue;
+            }
+            if (c < '0' || c > '9')
+                break;
+
+            hasDigits = true;
+            if (numSignificant < 19)
+            {
+                mantissa = mantissa * 10 + (uint64_t) (c - '0');
+                if (mantissa != 0)
+                    ++numSignificant;
+                if (hasDecimalPoint)
+                    --exponent;
+            }
+            else if (! hasDecimalPoint)
+            {
+                ++exponent;
+            }
+        }
+
+        if (! hasDigits)
+            return 0.0;
+
+        // an e only belongs to the number when digits follow it
+        if (i + 1 < text.size() && (text[i] == 'e' || text[i] == 'E'))
+        {
+            auto digit = i + 1;
+            const bool isExponentNegative = text[digit] == '-';
+            if ((text[digit] == '-' || text[digit] == '+') && digit + 1 < text.size())
+                ++digit;
+
+            int written = 0;
+            for (; digit < text.size() && text[digit] >= '0' && text[digit] <= '9'; ++digit)
+                written = std::min (written * 10 + (text[digit] - '0'), 100000);
+            exponent += isExponentNegative ? -written : written;
+        }
+
+        if (mantissa == 0)
+            return sign (0.0);
+
+        // both the mantissa and the power of ten are exact doubles, so one multiply or divide rounds correctly
+        constexpr double exactPowersOf10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        if (mantissa <= (uint64_t) 1 << 53 && exponent >= -22 && exponent <= 22)
+            return sign (exponent < 0 ? (double) mantissa / exactPowersOf10[-exponent] : (double) mantissa * exactPowersOf10[exponent]);
+
+        // this far out it overflows to inf and underflows to 0 like strtod
+        return sign ((double) ((long double) mantissa * std::pow (10.0L, (long double) exponent)));
+    }
+
+    // Like juce::String::getFloatValue<FloatType> (or getDoubleValue)
+    template <typename FloatType = float>
+    static inline FloatType getFloatValue (std::string_view text) noexcept
+    {
+        text = trimStart (text);
+
+        // juce (like strtod) takes a leading +, from_chars doesn't
+        if (text.size() > 1 && text[0] == '+' && text[1] != '-')
+            text.remove_prefix (1);
+
+        double value = 0.0;
+#if __cpp_lib_to_chars >= 201611L
+        if (std::from_chars (text.data(), text.data() + text.size(), value).ec == std::errc::result_out_of_range)
+            value = outOfRangeValue (text);
+#else
+        // Some standard libraries (such as older libc++) have no floating point from_chars
+        value = readDecimal (text);
+#endif
+        return (FloatType) value;
+    }
+
+    // Like juce::String::getIntValue, including how it wraps around on overflow
+    static inline int getIntValue (std::string_view text) noexcept
+    {
+        text = trimStart (text);
+
+        const bool isNegative = ! text.empty() && text.front() == '-';
+        if (isNegative)
+            text.remove_prefix (1);
+
+        unsigned int value = 0;
+        for (auto c : text)
+        {
+            if (c < '0' || c > '9')
+                break;
+            value = value * 10 + (unsigned int) (c - '0');
+        }
+
+        return isNegative ? - (int) value : (int) value;
+    }
+
+    // timeValueFromString: 0ms, 11.1ms, 100ms, 1.0s, 15.98s
+    // Without a unit, a decimal point means seconds and no decimal point means ms
+    template <typename FloatType = float>
+    static inline FloatType timeValue (std::string_view text) noexcept
+    {
+        if (endsWithIgnoreCase (text, "ms"))
+            return getFloatValue<FloatType> (dropLastCharacters (text, 2)) / (FloatType) 1000;
+
+        if (endsWithIgnoreCase (text, "s"))
+            return getFloatValue<FloatType> (dropLastCharacters (text, 1));
+
+        if (text.find ('.') != std::string_view::npos)
+            return getFloatValue<FloatType> (text);
+
+        return getFloatValue<FloatType> (text) / (FloatType) 1000;
+    }
+
+    // dBFromString
+    template <typename FloatType = float>
+    static inline FloatType dB (std::string_view text) noexcept
+    {
+        if (endsWithIgnoreCase (text, "db"))
+            return getFloatValue<FloatType> (dropLastCharacters (text, 2));
+
+        return getFloatValue<FloatType> (text);
+    }
+
+    // dBFromStringWithOffAt64
+    template <typename FloatType = float>
+    static inline FloatType dBWithOffAt64 (std::string_view text) noexcept
+    {
+        if (equalsIgnoreCase (text, "off"))
+            return -64;
+
+        return dB<FloatType> (text);
+    }
+
+    // intValueFromString
+    template <typename FloatType = float>
+    static inline FloatType intValue (std::string_view text) noexcept
+    {
+        return (FloatType) getIntValue (text);
+    }
+
+    // percentValueFromString, 50% and 50 are both 0.5
+    template <typename FloatType = float>
+    static inline FloatType percentValue (std::string_view text) noexcept
+    {
+        if (equalsIgnoreCase (text, "off"))
+            return 0;
+
+        if (endsWithIgnoreCase (text, "%"))
+            return getFloatValue<FloatType> (dropLastCharacters (text, 1)) / (FloatType) 100;
+
+        return getFloatValue<FloatType> (text) / (FloatType) 100;
+    }
+
+    // hzValueFromString
+    template <typename FloatType = float>
+    static inline FloatType hzValue (std::string_view text) noexcept
+    {
+        if (endsWithIgnoreCase (text, "khz"))
+            return getFloatValue<FloatType> (dropLastCharacters (text, 3)) * (FloatType) 1000;
+
+        if (endsWithIgnoreCase (text, "hz"))
+            return getFloatValue<FloatType> (dropLastCharacters (text, 2));
+
+        return getFloatValue<FloatType> (text);
+    }
+
+    // semiValueFromString
+    template <typename FloatType = float>
+    static inline FloatType semiValue (std::string_view text) noexcept
+    {
+        return (FloatType) getIntValue (text);
+    }
+
+    // zeroTo1FromString
+    template <typename FloatType = float>
+    static inline FloatType zeroTo1 (std::string_view text) noexcept
+    {
+        return getFloatValue<FloatType> (text);
+    }
+
+    // Strict parsing
+    //
+    // The functions above are as forgiving as juce::String::getFloatValue: "abc" is 0 and "12 parsecs" is 12.
+    // That's what a slider's text box wants, but not a preset or automation import, where bad text should be caught.
+    // melatonin::parse reads a number and an optional unit in one pass, then a unit policy below turns that into a value:
+    //
+    //    auto frequency = melatonin::parse<melatonin::parsers::Hz> ("1.2k"); // 1200.0f
+    //    if (! frequency)
+    //        reportBadPreset (frequency.error);
+    //
+    // Units match regardless of case, with or without a space before them: ms, s, Hz, kHz, k, dB, %, semi, and "off".
+    // Numbers can also be inf, like "-inf dB".
+    // The policies infer a missing unit the same way as the functions above (like "250" being 250ms)
+    enum class ParseError : uint8_t {
+        none,
+        empty, // nothing but whitespace
+        noNumber, // like "abc" or "-"
+        unknownUnit, // like "12 parsecs"
+        wrongUnit, // a unit the parameter doesn't take, like "10ms" for Hz
+        notFinite, // inf (or too big to be anything else), for a parameter that can't be infinite
+        exponent, // like "1e3", for a parameter that reads whole numbers the way getIntValue does (it would stop at the e)
+    };
+
+    enum class Unit : uint8_t {
+        none,
+        milliseconds,
+        seconds,
+        hz,
+        khz,
+        thousand, // a bare k, "1.2k"
+        decibels,
+        percent,
+        semitones,
+        off,
+    };
+
+    // A number and its unit, as written
+    struct Token
+    {
+        double number = 0;
+        bool hasNumber = false;
+        bool hasDecimalPoint = false;
+        bool hasExponent = false;
+        bool isInf = false; // written as inf, rather than a number too big for a double
+        Unit unit = Unit::none;
+        ParseError error = ParseError::none;
+    };
+
+    static inline bool isDigit (char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static inline Token tokenize (std::string_view text) noexcept
+    {
+        Token token;
+        text = trimStart (text);
+        while (! text.empty() && isWhitespace (text.back()))
+            text.remove_suffix (1);
+
+        if (text.empty())
+        {
+            token.error = ParseError::empty;
+            return token;
+        }
+
+        // the number: an optional sign, digits with at most one decimal point, then an optional exponent
+        size_t i = 0;
+        const bool isNegative = text[0] == '-';
+        if (text[0] == '-' || text[0] == '+')
+            ++i;
+
+        if (text.size() - i >= 3 && equalsIgnoreCase (text.substr (i, 3), "inf"))
+        {
+            token.number = isNegative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+            token.hasNumber = true;
+            token.isInf = true;
+            i += 3;
+        }
+        else
+        {
+            size_t numDigits = 0;
+            for (; i < text.size(); ++i)
+            {
+                if (isDigit (text[i]))
+                    ++numDigits;
+                else if (text[i] == '.' && ! token.hasDecimalPoint)
+                    token.hasDecimalPoint = true;
+                else
+                    break;
+            }
+
+            // an e only belongs to the number when digits follow it
+            if (numDigits > 0 && i + 1 < text.size() && (text[i] == 'e' || text[i] == 'E'))
+            {
+                auto exponentEnd = i + 1;
+                if (exponentEnd < text.size() - 1 && (text[exponentEnd] == '-' || text[exponentEnd] == '+'))
+                    ++exponentEnd;
+                if (isDigit (text[exponentEnd]))
+                {
+                    token.hasExponent = true;
+                    i = exponentEnd;
+                    while (i < text.size() && isDigit (text[i]))
+                        ++i;
+                }
+            }
+
+            if (numDigits > 0)
+            {
+                token.number = getFloatValue<double> (text.substr (0, i));
+                token.hasNumber = true;
+            }
+        }
+
+        // the unit is whatever's left, after any spaces
+        auto unit = trimStart (text.substr (token.hasNumber ? i : 0));
+        if (! token.hasNumber && ! equalsIgnoreCase (unit, "off"))
+        {
+            token.error = ParseError::noNumber;
+            return token;
+        }
+
+        constexpr std::pair<std::string_view, Unit> units[] = {
+            { "", Unit::none },
+            { "ms", Unit::milliseconds },
+            { "s", Unit::seconds },
+            { "hz", Unit::hz },
+            { "khz", Unit::khz },
+            { "k", Unit::thousand },
+            { "db", Unit::decibels },
+            { "%", Unit::percent },
+            { "semi", Unit::semitones },
+            { "off", Unit::off },
+        };
+
+        token.error = ParseError::unknownUnit;
+        for (const auto& [name, value] : units)
+        {
+            if (equalsIgnoreCase (unit, name))
+            {
+                token.unit = value;
+                token.error = ParseError::none;
+                break;
+            }
+        }
+
+        // "10 off" isn't a thing
+        if (token.unit == Unit::off && token.hasNumber)
+            token.error = ParseError::unknownUnit;
+
+        return token;
+    }
+
+    template <typename FloatType>
+    struct ParseResult
+    {
+        FloatType value = 0;
+        ParseError error = ParseError::none;
+
+        explicit operator bool() const noexcept { return error == ParseError::none; }
+
+        [[nodiscard]] FloatType valueOr (FloatType fallback) const noexcept { return error == ParseError::none ? value : fallback; }
+    };
+
+    // The unit policies, one per *FromString lambda
+    // Each takes a Token without an error and returns the value, or why that token makes no sense for the parameter
+    namespace detail
+    {
+        template <typename FloatType>
+        static inline ParseResult<FloatType> finite (FloatType value) noexcept
+        {
+            return { value, std::isfinite (value) ? ParseError::none : ParseError::notFinite };
+        }
+
+        template <typename FloatType>
+        static inline ParseResult<FloatType> wrongUnit() noexcept
+        {
+            return { 0, ParseError::wrongUnit };
+        }
+    }
+
+    // timeValue: ms or s, without a unit a decimal point means seconds
+    struct Time
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            const auto number = (FloatType) token.number;
+            switch (token.unit)
+            {
+                case Unit::milliseconds: return detail::finite (number / (FloatType) 1000);
+                case Unit::seconds: return detail::finite (number);
+                case Unit::none: return detail::finite (token.hasDecimalPoint ? number : number / (FloatType) 1000);
+                default: return detail::wrongUnit<FloatType>();
+            }
+        }
+    };
+
+    // dB, which can be -inf (but not +inf, or a number too big for FloatType)
+    struct Decibels
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            if (token.unit != Unit::decibels && token.unit != Unit::none)
+                return detail::wrongUnit<FloatType>();
+
+            if (token.isInf && token.number < 0)
+                return { -std::numeric_limits<FloatType>::infinity() };
+
+            return detail::finite ((FloatType) token.number);
+        }
+    };
+
+    // dBWithOffAt64, off is -64
+    struct DecibelsWithOffAt64
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            if (token.unit == Unit::off)
+                return { -64 };
+
+            return Decibels::fromToken<FloatType> (token);
+        }
+    };
+
+    // hzValue: Hz, kHz, or 1.2k
+    struct Hz
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            const auto number = (FloatType) token.number;
+            switch (token.unit)
+            {
+                case Unit::khz:
+                case Unit::thousand: return detail::finite (number * (FloatType) 1000);
+                case Unit::hz:
+                case Unit::none: return detail::finite (number);
+                default: return detail::wrongUnit<FloatType>();
+            }
+        }
+    };
+
+    // percentValue: 50% and 50 are both 0.5, off is 0
+    struct Percent
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            switch (token.unit)
+            {
+                case Unit::off: return { 0 };
+                case Unit::percent:
+                case Unit::none: return detail::finite ((FloatType) token.number / (FloatType) 100);
+                default: return detail::wrongUnit<FloatType>();
+            }
+        }
+    };
+
+    // intValue, anything after the decimal point is dropped like getIntValue does
+    struct Int
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            if (token.unit != Unit::none)
+                return detail::wrongUnit<FloatType>();
+
+            if (token.hasExponent)
+                return { 0, ParseError::exponent };
+
+            return detail::finite (std::trunc ((FloatType) token.number));
+        }
+    };
+
+    // semiValue, whole semitones
+    struct Semi
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            if (token.unit != Unit::semitones && token.unit != Unit::none)
+                return detail::wrongUnit<FloatType>();
+
+            if (token.hasExponent)
+                return { 0, ParseError::exponent };
+
+            return detail::finite (std::trunc ((FloatType) token.number));
+        }
+    };
+
+    // zeroTo1, a plain number
+    struct ZeroTo1
+    {
+        template <typename FloatType>
+        static ParseResult<FloatType> fromToken (const Token& token) noexcept
+        {
+            if (token.unit != Unit::none)
+                return detail::wrongUnit<FloatType>();
+
+            return detail::finite ((FloatType) token.number);
+        }
+    };
+}
+
+namespace melatonin
+{
+    // Parses text strictly for the parameter that UnitPolicy describes, see "Strict parsing" above
+    template <typename UnitPolicy, typename FloatType = float>
+    static inline parsers::ParseResult<FloatType> parse (std::string_view text) noexcept
+    {
+        const auto token = parsers::tokenize (text);
+        if (token.error != parsers::ParseError::none)
+            return { 0, token.error };
+
+        return UnitPolicy::template fromToken<FloatType> (token);
+    }
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+// A range made of up to MaxSegments segments, each linear or exponential
+//
+// logarithmicRangeWithLinearStart is the two segment version of this. With more breakpoints,
+// a frequency knob can have detail around both 80Hz and 1kHz, or a time knob can go linear, then log, then coarse:
+//
+//    auto frequency = melatonin::PiecewiseRange<> ({ { 0.0f, 20.0f }, { 0.3f, 120.0f, 3.0f }, { 0.6f, 1500.0f, 3.0f }, { 1.0f, 20000.0f, 4.0f } });
+//
+// Each breakpoint is (normalized, unnormalized, curve), both values have to rise from one breakpoint to the next,
+// and the first and last breakpoints have to sit at normalized 0 and 1.
+// Every segment's constants are worked out at construction, and finding the segment is a fixed number of compares,
+// so there's no branching on the value and the block conversions stay in straight lines.
+namespace melatonin
+{
+    template <size_t MaxSegments = 8>
+    class PiecewiseRange
+    {
+    public:
+        static_assert (MaxSegments >= 1 && MaxSegments < 256, "Segment indices are stored as bytes in the block conversions");
+
+        // curve shapes the segment that ends at this breakpoint, so the first breakpoint's curve is unused
+        //  * 0 is linear
+        //  * above 0 is the exponential curve of logarithmicRange, with curve as the exponent
+        //  * below 0 bends the other way, fast at first then slowing down
+        struct Breakpoint
+        {
+            float normalized = 0.0f;
+            float unnormalized = 0.0f;
+            float curve = 0.0f;
+        };
+
+        PiecewiseRange (std::initializer_list<Breakpoint> breakpoints, Accuracy accuracyToUse = Accuracy::exact) noexcept
+            : PiecewiseRange (breakpoints.begin(), breakpoints.size(), accuracyToUse)
+        {
+        }
+
+        PiecewiseRange (const Breakpoint* breakpoints, size_t numBreakpoints, Accuracy accuracyToUse = Accuracy::exact) noexcept
+            : numSegments (std::clamp (numBreakpoints, (size_t) 2, MaxSegments + 1) - 1), accuracy (accuracyToUse)
+        {
+            jassert (numBreakpoints >= 2 && numBreakpoints <= MaxSegments + 1);
+            jassert (breakpoints[0].normalized == 0.0f && breakpoints[numSegments].normalized == 1.0f);
+
+            // unused segments start past the end of either domain, so the lookup never lands in them
+            normalizedStarts.fill (std::numeric_limits<float>::infinity());
+            unnormalizedStarts.fill (std::numeric_limits<float>::infinity());
+
+            for (size_t i = 0; i < numSegments; ++i)
+            {
+                const auto& from = breakpoints[i];
+                const auto& to = breakpoints[i + 1];
+                jassert (to.normalized > from.normalized && to.unnormalized > from.unnormalized);
+
+                auto& segment = segments[i];
+                segment.normalizedStart = from.normalized;
+                segment.normalizedLength = to.normalized - from.normalized;
+                segment.inverseNormalizedLength = 1.0f / segment.normalizedLength;
+                segment.unnormalizedStart = from.unnormalized;
+                segment.unnormalizedLength = to.unnormalized - from.unnormalized;
+                segment.inverseUnnormalizedLength = 1.0f / segment.unnormalizedLength;
+
+                // A nearly flat curve is a linear segment, (2^kt - 1) / (2^k - 1) would lose all its precision
+                if (std::abs (to.curve) > 1.0e-4f)
+                {
+                    const auto curveRange = std::exp2 (to.curve) - 1.0f;
+                    segment.exponent = to.curve;
+                    segment.inverseExponent = 1.0f / to.curve;
+                    segment.curveRange = curveRange;
+                    segment.inverseCurveRange = 1.0f / curveRange;
+                    segment.linearWeight = 0.0f;
+                }
+
+                normalizedStarts[i] = from.normalized;
+                unnormalizedStarts[i] = from.unnormalized;
+            }
+
+            start = breakpoints[0].unnormalized;
+            end = breakpoints[numSegments].unnormalized;
+        }
+
+        // The same curve as logarithmicRangeWithLinearStart
+        // That factory's linear part always starts from 0, so the two only match when logStart is 0
+        static PiecewiseRange logWithLinearStart (float logStart, float logEnd, float exponent, float unnormalizedBreakpoint, float breakpointOnSlider = 0.25f, Accuracy accuracy = Accuracy::exact) noexcept
+        {
+            return { { { 0.0f, logStart }, { breakpointOnSlider, unnormalizedBreakpoint }, { 1.0f, logEnd, exponent } }, accuracy };
+        }
+
+        [[nodiscard]] float convertFrom0to1 (float normalized) const noexcept
+        {
+            const auto x = std::clamp (normalized, 0.0f, 1.0f);
+            const auto& segment = segments[segmentIndex (x, normalizedStarts)];
+            const auto t = (x - segment.normalizedStart) * segment.inverseNormalizedLength;
+
+            // linear segments have an exponent of 0, so exp2 gives exactly 1 and only the linear part is left
+            return segment.unnormalizedStart + segment.unnormalizedLength * (segment.linearWeight * t + segment.inverseCurveRange * (fastmath::exp2 (segment.exponent * t, accuracy) - 1.0f));
+        }
+
+        [[nodiscard]] float convertTo0to1 (float unnormalized) const noexcept
+        {
+            const auto y = std::clamp (unnormalized, start, end);
+            const auto& segment = segments[segmentIndex (y, unnormalizedStarts)];
+            const auto t = (y - segment.unnormalizedStart) * segment.inverseUnnormalizedLength;
+
+            // likewise, linear segments have a curveRange of 0, so log2 gives exactly 0
+            return std::clamp (segment.normalizedStart + segment.normalizedLength * (segment.linearWeight * t + segment.inverseExponent * fastmath::log2 (t * segment.curveRange + 1.0f, accuracy)), 0.0f, 1.0f);
+        }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            std::array<uint8_t, blockSize> indices;
+            std::array<float, blockSize> curved;
+
+            for (int offset = 0; offset < numValues; offset += blockSize)
+            {
+                const auto numInBlock = std::min (blockSize, numValues - offset);
+                auto* destination = unnormalized + offset;
+
+                // where in its segment each value is, then the curve for all of them at once
+                juce::FloatVectorOperations::clip (destination, normalized + offset, 0.0f, 1.0f, numInBlock);
+                for (size_t i = 0; i < (size_t) numInBlock; ++i)
+                {
+                    indices[i] = (uint8_t) segmentIndex (destination[i], normalizedStarts);
+                    const auto& segment = segments[indices[i]];
+                    destination[i] = (destination[i] - segment.normalizedStart) * segment.inverseNormalizedLength;
+                    curved[i] = segment.exponent * destination[i];
+                }
+
+                fastmath::exp2 (curved.data(), curved.data(), numInBlock, accuracy);
+
+                for (size_t i = 0; i < (size_t) numInBlock; ++i)
+                {
+                    const auto& segment = segments[indices[i]];
+                    destination[i] = segment.unnormalizedStart + segment.unnormalizedLength * (segment.linearWeight * destination[i] + segment.inverseCurveRange * (curved[i] - 1.0f));
+                }
+            }
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            std::array<uint8_t, blockSize> indices;
+            std::array<float, blockSize> curved;
+
+            for (int offset = 0; offset < numValues; offset += blockSize)
+            {
+                const auto numInBlock = std::min (blockSize, numValues - offset);
+                auto* destination = normalized + offset;
+
+                juce::FloatVectorOperations::clip (destination, unnormalized + offset, start, end, numInBlock);
+                for (size_t i = 0; i < (size_t) numInBlock; ++i)
+                {
+                    indices[i] = (uint8_t) segmentIndex (destination[i], unnormalizedStarts);
+                    const auto& segment = segments[indices[i]];
+                    destination[i] = (destination[i] - segment.unnormalizedStart) * segment.inverseUnnormalizedLength;
+                    curved[i] = destination[i] * segment.curveRange + 1.0f;
+                }
+
+                fastmath::log2 (curved.data(), curved.data(), numInBlock, accuracy);
+
+                for (size_t i = 0; i < (size_t) numInBlock; ++i)
+                {
+                    const auto& segment = segments[indices[i]];
+                    destination[i] = segment.normalizedStart + segment.normalizedLength * (segment.linearWeight * destination[i] + segment.inverseExponent * curved[i]);
+                }
+
+                juce::FloatVectorOperations::clip (destination, destination, 0.0f, 1.0f, numInBlock);
+            }
+        }
+
+        [[nodiscard]] float getStart() const noexcept { return start; }
+        [[nodiscard]] float getEnd() const noexcept { return end; }
+        [[nodiscard]] size_t getNumSegments() const noexcept { return numSegments; }
+        [[nodiscard]] Accuracy getAccuracy() const noexcept { return accuracy; }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+    private:
+        // the block conversions work through the values this many at a time, on the stack
+        static constexpr int blockSize = 64;
+
+        // unnormalized = unnormalizedStart + unnormalizedLength * (linearWeight * t + (2^(exponent * t) - 1) / curveRange)
+        // where t is how far through the segment the normalized value is
+        struct Segment
+        {
+            float normalizedStart = 0.0f, normalizedLength = 1.0f, inverseNormalizedLength = 1.0f;
+            float unnormalizedStart = 0.0f, unnormalizedLength = 1.0f, inverseUnnormalizedLength = 1.0f;
+
+            // curveRange is 2^exponent - 1, these are all 0 for a linear segment
+            float exponent = 0.0f, inverseExponent = 0.0f;
+            float curveRange = 0.0f, inverseCurveRange = 0.0f;
+            float linearWeight = 1.0f;
+        };
+
+        std::array<Segment, MaxSegments> segments {};
+        std::array<float, MaxSegments> normalizedStarts {}, unnormalizedStarts {};
+        size_t numSegments;
+        float start = 0.0f, end = 1.0f;
+        Accuracy accuracy;
+
+        // The number of segments after the first that start at or before value
+        // Always MaxSegments - 1 compares, which the compiler can unroll and vectorize
+        static size_t segmentIndex (float value, const std::array<float, MaxSegments>& starts) noexcept
+        {
+            size_t index = 0;
+            for (size_t i = 1; i < MaxSegments; ++i)
+                index += value >= starts[i] ? 1 : 0;
+            return index;
+        }
+    };
+}
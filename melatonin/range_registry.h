@@ -0,0 +1,82 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+// Shares one juce::NormalisableRange between every parameter that asks for the same range
+//
+// Every band of an EQ wants the same logarithmicRange (20, 20000, 10), and every instance of the plugin
+// wants the same again. The registry interns ranges by value, so each distinct range is built once
+// and everyone else gets a handle to that one:
+//
+//    auto frequency = melatonin::RangeRegistry::getInstance().intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+//    juce::AudioParameterFloat ("frequency", "Frequency", *frequency, 1000.0f);
+//
+// The parameter keeps its own copy of *frequency, which is cheap: the interned range converts through small captures
+// of its constants, so copying it doesn't allocate.
+// Handles are immutable and keep their range alive. Once the last handle for a range goes away, so does the range.
+// Everything is behind a mutex, so instances loading on different threads can intern at the same time.
+// That makes interning a message thread (or loading) operation, not one for the audio thread.
+namespace melatonin
+{
+    class RangeRegistry
+    {
+    public:
+        using Handle = std::shared_ptr<const juce::NormalisableRange<float>>;
+
+        RangeRegistry() = default;
+
+        // The one every plugin instance in the process shares
+        static RangeRegistry& getInstance()
+        {
+            static RangeRegistry registry;
+            return registry;
+        }
+
+        [[nodiscard]] Handle intern (const CompactRange& range)
+        {
+            const std::scoped_lock lock (mutex);
+
+            auto& entry = ranges[range];
+            if (auto existing = entry.lock())
+                return existing;
+
+            Handle handle = std::make_shared<const juce::NormalisableRange<float>> (range);
+            entry = handle;
+
+            // Ranges that are no longer used are cleaned up once in a while, rather than on every release
+            if (++numInternedSinceCleanup >= cleanupInterval)
+                removeExpired();
+
+            return handle;
+        }
+
+        // How many distinct ranges still have a handle somewhere
+        [[nodiscard]] size_t getNumUniqueRanges()
+        {
+            const std::scoped_lock lock (mutex);
+            removeExpired();
+            return ranges.size();
+        }
+
+    private:
+        struct Hash
+        {
+            size_t operator() (const CompactRange& range) const noexcept { return range.hash(); }
+        };
+
+        static constexpr size_t cleanupInterval = 256;
+
+        std::mutex mutex;
+        std::unordered_map<CompactRange, std::weak_ptr<const juce::NormalisableRange<float>>, Hash> ranges;
+        size_t numInternedSinceCleanup = 0;
+
+        void removeExpired()
+        {
+            for (auto it = ranges.begin(); it != ranges.end();)
+                it = it->second.expired() ? ranges.erase (it) : std::next (it);
+
+            numInternedSinceCleanup = 0;
+        }
+    };
+}
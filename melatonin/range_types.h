@@ -0,0 +1,677 @@
+#pragma once
+
+// Concrete value types for the ranges in ranges.h
+//
+// juce::NormalisableRange goes through std::function for every conversion, and the lambdas in ranges.h
+// recompute things like exp2 (exponent) on every call. These types work out their constants once
+// at construction, so the conversions are small inlineable functions.
+//
+// They behave like the matching factory, including NormalisableRange's clamping of normalized values to 0-1,
+// and they convert to juce::NormalisableRange<float> for the APVTS:
+//
+//    juce::AudioParameterFloat ("release", "Release", melatonin::LogRange (0.0f, 15.0f), 0.1f)
+//
+// The log and decibel types take an Accuracy as their last argument, see fast_math.h
+//
+// Every constructor is constexpr, so a whole parameter table can be worked out at compile time
+// and live in read only memory, see the short factories at the bottom of this file
+namespace melatonin
+{
+    // std::function keeps a callable in place when it's trivially copyable and at most 16 bytes (libstdc++ has the smallest buffer).
+    // Anything bigger is allocated when the NormalisableRange is made, and again every time it's copied
+    template <typename Function>
+    static constexpr bool fitsInStdFunction = std::is_trivially_copyable_v<Function> && sizeof (Function) <= 16;
+
+    // Range types with a withConverters (callback) method hand callback a from0to1 and a to0to1 function,
+    // each (rangeStart, rangeEnd, value) like a NormalisableRange's, capturing only the constants that direction needs
+    struct ConvertersProbe
+    {
+        template <typename From0to1, typename To0to1>
+        int operator() (From0to1, To0to1) const { return 0; }
+    };
+
+    template <typename RangeType, typename = void>
+    struct hasConverters : std::false_type
+    {
+    };
+
+    template <typename RangeType>
+    struct hasConverters<RangeType, std::void_t<decltype (std::declval<const RangeType&>().withConverters (ConvertersProbe()))>> : std::true_type
+    {
+    };
+
+    // Wraps any of the range types below in a juce::NormalisableRange
+    // Only needed at the APVTS boundary, as it reintroduces the std::function call
+    template <typename RangeType>
+    static inline juce::NormalisableRange<float> toNormalisableRange (const RangeType& range)
+    {
+        if constexpr (hasConverters<RangeType>::value)
+        {
+            return range.withConverters ([&] (auto from0to1, auto to0to1) {
+                static_assert (fitsInStdFunction<decltype (from0to1)> && fitsInStdFunction<decltype (to0to1)>, "The converters would allocate");
+                return juce::NormalisableRange<float> { range.getStart(), range.getEnd(), from0to1, to0to1 };
+            });
+        }
+        else
+        {
+            // big ranges like PiecewiseRange and LookupTableRange get copied into the lambdas whole, which allocates
+            return {
+                range.getStart(), range.getEnd(),
+                [range] (float, float, float normalized) { return range.convertFrom0to1 (normalized); },
+                [range] (float, float, float unnormalized) { return range.convertTo0to1 (unnormalized); }
+            };
+        }
+    }
+
+    template <typename RangeType, typename = void>
+    struct hasBlockConversion : std::false_type
+    {
+    };
+
+    template <typename RangeType>
+    struct hasBlockConversion<RangeType, std::void_t<decltype (std::declval<const RangeType&>().convertFrom0to1 ((const float*) nullptr, (float*) nullptr, 0))>> : std::true_type
+    {
+    };
+
+    // Convert a block through the range's block method when it has one,
+    // otherwise (like for a juce::NormalisableRange) one value at a time
+    template <typename RangeType>
+    static inline void convertFrom0to1 (const RangeType& range, const float* normalized, float* unnormalized, int numValues) noexcept
+    {
+        if constexpr (hasBlockConversion<RangeType>::value)
+        {
+            range.convertFrom0to1 (normalized, unnormalized, numValues);
+        }
+        else
+        {
+            for (int i = 0; i < numValues; ++i)
+                unnormalized[i] = range.convertFrom0to1 (normalized[i]);
+        }
+    }
+
+    template <typename RangeType>
+    static inline void convertTo0to1 (const RangeType& range, const float* unnormalized, float* normalized, int numValues) noexcept
+    {
+        if constexpr (hasBlockConversion<RangeType>::value)
+        {
+            range.convertTo0to1 (unnormalized, normalized, numValues);
+        }
+        else
+        {
+            for (int i = 0; i < numValues; ++i)
+                normalized[i] = range.convertTo0to1 (unnormalized[i]);
+        }
+    }
+
+    class LinearRange
+    {
+    public:
+        constexpr LinearRange (float startToUse, float endToUse) noexcept
+            : start (startToUse), end (endToUse), length (endToUse - startToUse), inverseLength (1.0f / (endToUse - startToUse))
+        {
+        }
+
+        [[nodiscard]] constexpr float convertFrom0to1 (float normalized) const noexcept { return from0to1 (normalized, start, length); }
+        [[nodiscard]] constexpr float convertTo0to1 (float unnormalized) const noexcept { return to0to1 (unnormalized, start, inverseLength); }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            juce::FloatVectorOperations::clip (unnormalized, normalized, 0.0f, 1.0f, numValues);
+            juce::FloatVectorOperations::multiply (unnormalized, length, numValues);
+            juce::FloatVectorOperations::add (unnormalized, start, numValues);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            juce::FloatVectorOperations::add (normalized, unnormalized, -start, numValues);
+            juce::FloatVectorOperations::multiply (normalized, inverseLength, numValues);
+            juce::FloatVectorOperations::clip (normalized, normalized, 0.0f, 1.0f, numValues);
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return start; }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return end; }
+
+        // the whole range is 16 bytes, so it fits in each std::function as is
+        template <typename Callback>
+        auto withConverters (Callback&& callback) const
+        {
+            return callback ([range = *this] (float, float, float normalized) { return range.convertFrom0to1 (normalized); },
+                [range = *this] (float, float, float unnormalized) { return range.convertTo0to1 (unnormalized); });
+        }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+        // the line on its own, shared by the members and CompactRange
+        [[nodiscard]] static constexpr float from0to1 (float normalized, float start, float length) noexcept
+        {
+            return start + std::clamp (normalized, 0.0f, 1.0f) * length;
+        }
+
+        [[nodiscard]] static constexpr float to0to1 (float unnormalized, float start, float inverseLength) noexcept
+        {
+            return std::clamp ((unnormalized - start) * inverseLength, 0.0f, 1.0f);
+        }
+
+    private:
+        float start, end, length, inverseLength;
+    };
+
+    // https://www.desmos.com/calculator/qkc6naksy5
+    // Same curve as logarithmicRange, see the README for the math
+    class LogRange
+    {
+    public:
+        constexpr LogRange (float logStart, float logEnd, float exponentToUse = 6.0f, Accuracy accuracyToUse = Accuracy::exact) noexcept
+            : start (logStart), end (logEnd), exponent (exponentToUse), inverseExponent (1.0f / exponentToUse),
+              scale ((logEnd - logStart) / (float) (fastmath::constexprExp2 (exponentToUse) - 1)), inverseScale (1.0f / scale), accuracy (accuracyToUse)
+        {
+        }
+
+        [[nodiscard]] float convertFrom0to1 (float normalized) const noexcept { return from0to1 (normalized, start, exponent, scale, accuracy); }
+        [[nodiscard]] float convertTo0to1 (float unnormalized) const noexcept { return to0to1 (unnormalized, start, inverseExponent, inverseScale, accuracy); }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            juce::FloatVectorOperations::clip (unnormalized, normalized, 0.0f, 1.0f, numValues);
+            juce::FloatVectorOperations::multiply (unnormalized, exponent, numValues);
+            fastmath::exp2 (unnormalized, unnormalized, numValues, accuracy);
+
+            // start + (2^kx - 1) * scale
+            juce::FloatVectorOperations::multiply (unnormalized, scale, numValues);
+            juce::FloatVectorOperations::add (unnormalized, start - scale, numValues);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            // (x - start) / scale + 1
+            juce::FloatVectorOperations::multiply (normalized, unnormalized, inverseScale, numValues);
+            juce::FloatVectorOperations::add (normalized, 1.0f - start * inverseScale, numValues);
+            fastmath::log2 (normalized, normalized, numValues, accuracy);
+
+            juce::FloatVectorOperations::multiply (normalized, inverseExponent, numValues);
+            juce::FloatVectorOperations::clip (normalized, normalized, 0.0f, 1.0f, numValues);
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return start; }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return end; }
+        [[nodiscard]] constexpr float getExponent() const noexcept { return exponent; }
+        [[nodiscard]] constexpr Accuracy getAccuracy() const noexcept { return accuracy; }
+
+        template <typename Callback>
+        auto withConverters (Callback&& callback) const
+        {
+            return callback (
+                [start = start, exponent = exponent, scale = scale, accuracy = accuracy] (float, float, float normalized) {
+                    return from0to1 (normalized, start, exponent, scale, accuracy);
+                },
+                [start = start, inverseExponent = inverseExponent, inverseScale = inverseScale, accuracy = accuracy] (float, float, float unnormalized) {
+                    return to0to1 (unnormalized, start, inverseExponent, inverseScale, accuracy);
+                });
+        }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+        // the curve on its own, shared by the members, the converters and CompactRange
+        [[nodiscard]] static float from0to1 (float normalized, float start, float exponent, float scale, Accuracy accuracy) noexcept
+        {
+            return start + (fastmath::exp2 (std::clamp (normalized, 0.0f, 1.0f) * exponent, accuracy) - 1) * scale;
+        }
+
+        [[nodiscard]] static float to0to1 (float unnormalized, float start, float inverseExponent, float inverseScale, Accuracy accuracy) noexcept
+        {
+            return std::clamp (fastmath::log2 ((unnormalized - start) * inverseScale + 1, accuracy) * inverseExponent, 0.0f, 1.0f);
+        }
+
+    private:
+        float start, end, exponent, inverseExponent;
+
+        // (end - start) / (2^k - 1)
+        float scale, inverseScale;
+        Accuracy accuracy;
+    };
+
+    // https://www.desmos.com/calculator/lz92tpns3b
+    // Same curve as logarithmicRangeWithLinearStart
+    class LogRangeWithLinearStart
+    {
+    public:
+        // unnormalizedBreakpoint should be at or above logStart, like logarithmicRangeWithLinearStart asserts
+        constexpr LogRangeWithLinearStart (float logStart, float logEnd, float exponentToUse, float unnormalizedBreakpointToUse, float breakpointOnSliderToUse = 0.25f, Accuracy accuracyToUse = Accuracy::exact) noexcept
+            : start (logStart), end (logEnd), exponent (exponentToUse),
+              unnormalizedBreakpoint (unnormalizedBreakpointToUse), breakpointOnSlider (breakpointOnSliderToUse),
+              linearFrom0to1Slope ((unnormalizedBreakpointToUse - logStart) / breakpointOnSliderToUse),
+              linearTo0to1Slope (breakpointOnSliderToUse / unnormalizedBreakpointToUse),
+              logFrom0to1Exponent (exponentToUse / (1.0f - breakpointOnSliderToUse)),
+              logTo0to1Scale ((1.0f - breakpointOnSliderToUse) / exponentToUse),
+              scale ((logEnd - unnormalizedBreakpointToUse) / (float) (fastmath::constexprExp2 (exponentToUse) - 1)),
+              inverseScale (1.0f / scale), accuracy (accuracyToUse)
+        {
+        }
+
+        [[nodiscard]] float convertFrom0to1 (float normalized) const noexcept
+        {
+            return from0to1 (normalized, unnormalizedBreakpoint, breakpointOnSlider, linearFrom0to1Slope, logFrom0to1Exponent, scale, accuracy);
+        }
+
+        [[nodiscard]] float convertTo0to1 (float unnormalized) const noexcept
+        {
+            return to0to1 (unnormalized, unnormalizedBreakpoint, breakpointOnSlider, linearTo0to1Slope, logTo0to1Scale, inverseScale, accuracy);
+        }
+
+        // Both segments are worked out for every value, and each lane keeps the one it's on
+        // std::exp2 has no SIMD version, so the exact tier goes a value at a time (like fastmath::exp2 does)
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            fastmath::withAccuracy (accuracy, [&] (auto accuracyTag) {
+                constexpr auto tier = decltype (accuracyTag)::value;
+                if constexpr (tier == Accuracy::exact)
+                {
+                    for (int i = 0; i < numValues; ++i)
+                        unnormalized[i] = convertFrom0to1 (normalized[i]);
+                }
+                else
+                {
+                    simd::apply (normalized, unnormalized, numValues, [this] (auto value) {
+                        using Vec = decltype (value);
+                        const auto x = simd::min (simd::max (value, simd::broadcast<Vec> (0.0f)), simd::broadcast<Vec> (1.0f));
+                        const auto linear = simd::mul (x, simd::broadcast<Vec> (linearFrom0to1Slope));
+                        const auto exponential = fastmath::exp2<tier> (simd::mul (simd::sub (x, simd::broadcast<Vec> (breakpointOnSlider)), simd::broadcast<Vec> (logFrom0to1Exponent)));
+                        const auto log = simd::add (simd::broadcast<Vec> (unnormalizedBreakpoint), simd::mul (simd::sub (exponential, simd::broadcast<Vec> (1.0f)), simd::broadcast<Vec> (scale)));
+                        return simd::select (simd::isBelow (x, simd::broadcast<Vec> (breakpointOnSlider)), linear, log);
+                    });
+                }
+            });
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            fastmath::withAccuracy (accuracy, [&] (auto accuracyTag) {
+                constexpr auto tier = decltype (accuracyTag)::value;
+                if constexpr (tier == Accuracy::exact)
+                {
+                    for (int i = 0; i < numValues; ++i)
+                        normalized[i] = convertTo0to1 (unnormalized[i]);
+                }
+                else
+                {
+                    // below the breakpoint, the log segment takes the log of something negative, which the select throws away
+                    simd::apply (unnormalized, normalized, numValues, [this] (auto value) {
+                        using Vec = decltype (value);
+                        const auto linear = simd::mul (value, simd::broadcast<Vec> (linearTo0to1Slope));
+                        const auto logarithm = fastmath::log2<tier> (simd::add (simd::mul (simd::sub (value, simd::broadcast<Vec> (unnormalizedBreakpoint)), simd::broadcast<Vec> (inverseScale)), simd::broadcast<Vec> (1.0f)));
+                        const auto log = simd::add (simd::broadcast<Vec> (breakpointOnSlider), simd::mul (simd::broadcast<Vec> (logTo0to1Scale), logarithm));
+                        const auto x = simd::select (simd::isBelow (value, simd::broadcast<Vec> (unnormalizedBreakpoint)), linear, log);
+                        return simd::min (simd::max (x, simd::broadcast<Vec> (0.0f)), simd::broadcast<Vec> (1.0f));
+                    });
+                }
+            });
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return start; }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return end; }
+
+        // Each direction needs 4 constants, so the accuracy is baked into the function instead of captured,
+        // and the linear slopes are worked out from the start on the fly (the same float math as the constructor)
+        template <typename Callback>
+        auto withConverters (Callback&& callback) const
+        {
+            return fastmath::withAccuracy (accuracy, [&] (auto accuracyTag) {
+                return callback (
+                    [breakpoint = unnormalizedBreakpoint, breakpointOnSlider = breakpointOnSlider, logFrom0to1Exponent = logFrom0to1Exponent, scale = scale] (float rangeStart, float, float normalized) {
+                        return from0to1 (normalized, breakpoint, breakpointOnSlider, (breakpoint - rangeStart) / breakpointOnSlider, logFrom0to1Exponent, scale, decltype (accuracyTag)::value);
+                    },
+                    [breakpoint = unnormalizedBreakpoint, breakpointOnSlider = breakpointOnSlider, logTo0to1Scale = logTo0to1Scale, inverseScale = inverseScale] (float, float, float unnormalized) {
+                        return to0to1 (unnormalized, breakpoint, breakpointOnSlider, breakpointOnSlider / breakpoint, logTo0to1Scale, inverseScale, decltype (accuracyTag)::value);
+                    });
+            });
+        }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+        // the curve on its own, shared by the members, the converters and CompactRange
+        [[nodiscard]] static float from0to1 (float normalized, float breakpoint, float breakpointOnSlider, float linearSlope, float logExponent, float scale, Accuracy accuracy) noexcept
+        {
+            const auto x = std::clamp (normalized, 0.0f, 1.0f);
+            if (x < breakpointOnSlider)
+                return x * linearSlope;
+
+            return breakpoint + (fastmath::exp2 ((x - breakpointOnSlider) * logExponent, accuracy) - 1) * scale;
+        }
+
+        [[nodiscard]] static float to0to1 (float unnormalized, float breakpoint, float breakpointOnSlider, float linearSlope, float logScale, float inverseScale, Accuracy accuracy) noexcept
+        {
+            if (unnormalized < breakpoint)
+                return std::clamp (unnormalized * linearSlope, 0.0f, 1.0f);
+
+            return std::clamp (breakpointOnSlider + logScale * fastmath::log2 ((unnormalized - breakpoint) * inverseScale + 1, accuracy), 0.0f, 1.0f);
+        }
+
+    private:
+        float start, end, exponent, unnormalizedBreakpoint, breakpointOnSlider;
+        float linearFrom0to1Slope, linearTo0to1Slope;
+        float logFrom0to1Exponent, logTo0to1Scale;
+
+        // (end - unnormalizedBreakpoint) / (2^k - 1)
+        float scale, inverseScale;
+        Accuracy accuracy;
+    };
+
+    // Same mapping as decibelRange (minimum, maximum), which is linear in dB (see ranges.h)
+    // The gain methods skip the dB step for gain staging, they are the only ones where accuracy matters
+    class DecibelRange
+    {
+    public:
+        constexpr DecibelRange (float minimumToUse, float maximumToUse, Accuracy accuracyToUse = Accuracy::exact) noexcept
+            : decibels (minimumToUse, maximumToUse),
+              minimumGain ((float) fastmath::constexprExp2 (minimumToUse * 0.05 * 3.321928094887362)),
+              log2GainRatio ((maximumToUse - minimumToUse) * 0.05f * 3.321928094887362f),
+              accuracy (accuracyToUse)
+        {
+        }
+
+        [[nodiscard]] constexpr float convertFrom0to1 (float normalized) const noexcept { return decibels.convertFrom0to1 (normalized); }
+        [[nodiscard]] constexpr float convertTo0to1 (float dB) const noexcept { return decibels.convertTo0to1 (dB); }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            decibels.convertFrom0to1 (normalized, unnormalized, numValues);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            decibels.convertTo0to1 (unnormalized, normalized, numValues);
+        }
+
+        // Same as juce::Decibels::decibelsToGain (convertFrom0to1 (normalized)), with one exp2
+        [[nodiscard]] float gainFrom0to1 (float normalized) const noexcept
+        {
+            return minimumGain * fastmath::exp2 (std::clamp (normalized, 0.0f, 1.0f) * log2GainRatio, accuracy);
+        }
+
+        void gainFrom0to1 (const float* normalized, float* gains, int numValues) const noexcept
+        {
+            juce::FloatVectorOperations::clip (gains, normalized, 0.0f, 1.0f, numValues);
+            juce::FloatVectorOperations::multiply (gains, log2GainRatio, numValues);
+            fastmath::exp2 (gains, gains, numValues, accuracy);
+            juce::FloatVectorOperations::multiply (gains, minimumGain, numValues);
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return decibels.getStart(); }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return decibels.getEnd(); }
+        [[nodiscard]] constexpr Accuracy getAccuracy() const noexcept { return accuracy; }
+
+        // the conversions are linear in dB, the gain constants don't need to come along
+        template <typename Callback>
+        auto withConverters (Callback&& callback) const
+        {
+            return decibels.withConverters (std::forward<Callback> (callback));
+        }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+    private:
+        LinearRange decibels;
+
+        // gain = minimumGain * 2^(normalized * log2 (maximumGain / minimumGain))
+        float minimumGain, log2GainRatio;
+        Accuracy accuracy;
+    };
+
+    // Same mapping as decibelRangeForHarmonic, the max gain for any given harmonic is 1/f
+    class HarmonicDecibelRange
+    {
+    public:
+        // minimum should be below 0dB, like decibelRangeForHarmonic asserts
+        constexpr explicit HarmonicDecibelRange (size_t harmonicNumberToUse, float minimumToUse = -100.f, Accuracy accuracyToUse = Accuracy::exact) noexcept
+            : harmonicNumber ((float) harmonicNumberToUse), inverseHarmonicNumber (1.0f / (float) harmonicNumberToUse),
+              // juce::Decibels::gainToDecibels (1 / harmonicNumber, minimum), as 20 * log10 (1 / n) = -20 * log2 (n) / log2 (10)
+              minimum (minimumToUse), maximum (std::max (minimumToUse, (float) (-20.0 * fastmath::constexprLog2 ((double) harmonicNumberToUse) * 0.3010299956639812))),
+              accuracy (accuracyToUse)
+        {
+        }
+
+        [[nodiscard]] float convertFrom0to1 (float normalizedGain) const noexcept { return from0to1 (normalizedGain, inverseHarmonicNumber, minimum, accuracy); }
+        [[nodiscard]] float convertTo0to1 (float dB) const noexcept { return to0to1 (dB, harmonicNumber, minimum, accuracy); }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            juce::FloatVectorOperations::clip (unnormalized, normalized, 0.0f, 1.0f, numValues);
+            juce::FloatVectorOperations::multiply (unnormalized, inverseHarmonicNumber, numValues);
+            fastmath::gainToDecibels (unnormalized, unnormalized, numValues, minimum, accuracy);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            fastmath::decibelsToGain (unnormalized, normalized, numValues, minimum, accuracy);
+            juce::FloatVectorOperations::multiply (normalized, harmonicNumber, numValues);
+            juce::FloatVectorOperations::clip (normalized, normalized, 0.0f, 1.0f, numValues);
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return minimum; }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return maximum; }
+
+        template <typename Callback>
+        auto withConverters (Callback&& callback) const
+        {
+            return callback (
+                [inverseHarmonicNumber = inverseHarmonicNumber, minimum = minimum, accuracy = accuracy] (float, float, float normalizedGain) {
+                    return from0to1 (normalizedGain, inverseHarmonicNumber, minimum, accuracy);
+                },
+                [harmonicNumber = harmonicNumber, minimum = minimum, accuracy = accuracy] (float, float, float dB) {
+                    return to0to1 (dB, harmonicNumber, minimum, accuracy);
+                });
+        }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+        // the curve on its own, shared by the members, the converters and CompactRange
+        [[nodiscard]] static float from0to1 (float normalizedGain, float inverseHarmonicNumber, float minimum, Accuracy accuracy) noexcept
+        {
+            return fastmath::gainToDecibels (std::clamp (normalizedGain, 0.0f, 1.0f) * inverseHarmonicNumber, minimum, accuracy);
+        }
+
+        [[nodiscard]] static float to0to1 (float dB, float harmonicNumber, float minimum, Accuracy accuracy) noexcept
+        {
+            // This can sometimes result in a number just barely above 1.0f
+            return std::clamp (harmonicNumber * fastmath::decibelsToGain (dB, minimum, accuracy), 0.0f, 1.0f);
+        }
+
+    private:
+        float harmonicNumber, inverseHarmonicNumber, minimum, maximum;
+        Accuracy accuracy;
+    };
+
+    // Same mapping as intRangeWithMidPoint: linear on both sides of the midpoint, which sits at 0.5
+    class IntRangeWithMidPoint
+    {
+    public:
+        constexpr IntRangeWithMidPoint (int min, int max, int midpointToUse) noexcept
+            : start ((float) min), end ((float) max), midpoint ((float) midpointToUse),
+              lowerFrom0to1Slope (2.0f * ((float) midpointToUse - (float) min)), upperFrom0to1Slope (2.0f * ((float) max - (float) midpointToUse)),
+              lowerTo0to1Slope (0.5f / ((float) midpointToUse - (float) min)), upperTo0to1Slope (0.5f / ((float) max - (float) midpointToUse))
+        {
+        }
+
+        [[nodiscard]] constexpr float convertFrom0to1 (float normalized) const noexcept
+        {
+            return from0to1 (normalized, start, end, midpoint, lowerFrom0to1Slope, upperFrom0to1Slope);
+        }
+
+        [[nodiscard]] constexpr float convertTo0to1 (float unnormalized) const noexcept
+        {
+            return to0to1 (unnormalized, start, midpoint, lowerTo0to1Slope, upperTo0to1Slope);
+        }
+
+        // Both sides of the midpoint are worked out for every value, and each lane keeps the one it's on
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            simd::apply (normalized, unnormalized, numValues, [this] (auto value) {
+                using Vec = decltype (value);
+                const auto x = simd::min (simd::max (value, simd::broadcast<Vec> (0.0f)), simd::broadcast<Vec> (1.0f));
+                const auto lower = simd::add (simd::mul (x, simd::broadcast<Vec> (lowerFrom0to1Slope)), simd::broadcast<Vec> (start));
+                const auto upper = simd::add (simd::broadcast<Vec> (midpoint), simd::mul (simd::sub (x, simd::broadcast<Vec> (0.5f)), simd::broadcast<Vec> (upperFrom0to1Slope)));
+                const auto result = simd::select (simd::isAtOrBelow (x, simd::broadcast<Vec> (0.5f)), lower, upper);
+                return simd::min (simd::max (result, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (end));
+            });
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            simd::apply (unnormalized, normalized, numValues, [this] (auto value) {
+                using Vec = decltype (value);
+                const auto lower = simd::mul (simd::sub (value, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (lowerTo0to1Slope));
+                const auto upper = simd::add (simd::broadcast<Vec> (0.5f), simd::mul (simd::sub (value, simd::broadcast<Vec> (midpoint)), simd::broadcast<Vec> (upperTo0to1Slope)));
+                const auto result = simd::select (simd::isAtOrBelow (value, simd::broadcast<Vec> (midpoint)), lower, upper);
+                return simd::min (simd::max (result, simd::broadcast<Vec> (0.0f)), simd::broadcast<Vec> (1.0f));
+            });
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return start; }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return end; }
+        [[nodiscard]] constexpr float getMidpoint() const noexcept { return midpoint; }
+
+        // start and end come from the NormalisableRange, so each direction only captures 3 floats
+        template <typename Callback>
+        auto withConverters (Callback&& callback) const
+        {
+            return callback (
+                [midpoint = midpoint, lowerSlope = lowerFrom0to1Slope, upperSlope = upperFrom0to1Slope] (float rangeStart, float rangeEnd, float normalized) {
+                    return from0to1 (normalized, rangeStart, rangeEnd, midpoint, lowerSlope, upperSlope);
+                },
+                [midpoint = midpoint, lowerSlope = lowerTo0to1Slope, upperSlope = upperTo0to1Slope] (float rangeStart, float, float unnormalized) {
+                    return to0to1 (unnormalized, rangeStart, midpoint, lowerSlope, upperSlope);
+                });
+        }
+
+        // Like intRangeWithMidPoint, this snaps to whole numbers and has an interval of 1
+        operator juce::NormalisableRange<float>() const
+        {
+            auto range = withConverters ([this] (auto from0to1, auto to0to1) {
+                static_assert (fitsInStdFunction<decltype (from0to1)> && fitsInStdFunction<decltype (to0to1)>, "The converters would allocate");
+                return juce::NormalisableRange<float> { start, end, from0to1, to0to1, SnapToInt() };
+            });
+
+            range.setSkewForCentre (midpoint);
+            range.interval = 1.0f;
+            return range;
+        }
+
+        // the curve on its own, shared by the members, the converters and CompactRange
+        [[nodiscard]] static constexpr float from0to1 (float normalized, float start, float end, float midpoint, float lowerSlope, float upperSlope) noexcept
+        {
+            const auto x = std::clamp (normalized, 0.0f, 1.0f);
+            return std::clamp (x <= 0.5f ? x * lowerSlope + start : midpoint + (x - 0.5f) * upperSlope, start, end);
+        }
+
+        [[nodiscard]] static constexpr float to0to1 (float unnormalized, float start, float midpoint, float lowerSlope, float upperSlope) noexcept
+        {
+            return std::clamp (unnormalized <= midpoint ? (unnormalized - start) * lowerSlope : 0.5f + (unnormalized - midpoint) * upperSlope, 0.0f, 1.0f);
+        }
+
+    private:
+        float start, end, midpoint;
+        float lowerFrom0to1Slope, upperFrom0to1Slope;
+        float lowerTo0to1Slope, upperTo0to1Slope;
+    };
+
+    // Flips the direction of any range type (including PiecewiseRange and CompactRange),
+    // so the knob starts at the end. The arguments stay in the same order, lowest possibility first:
+    //
+    //    juce::AudioParameterFloat ("release", "Release", melatonin::reversed (melatonin::LogRange (0.0f, 15.0f)), 0.1f)
+    //
+    // Each conversion is the wrapped range's, with a 1 - x on the normalized side.
+    // That's the same as reversedLogarithmicRange, without a second copy of the curve.
+    template <typename RangeType>
+    class Reversed
+    {
+    public:
+        constexpr explicit Reversed (const RangeType& rangeToReverse) noexcept : range (rangeToReverse)
+        {
+        }
+
+        // the wrapped range clamps 1 - x to 0-1, which is the same as clamping x
+        [[nodiscard]] constexpr float convertFrom0to1 (float normalized) const noexcept
+        {
+            return range.convertFrom0to1 (1.0f - normalized);
+        }
+
+        [[nodiscard]] constexpr float convertTo0to1 (float unnormalized) const noexcept
+        {
+            return 1.0f - range.convertTo0to1 (unnormalized);
+        }
+
+        void convertFrom0to1 (const float* normalized, float* unnormalized, int numValues) const noexcept
+        {
+            simd::apply (normalized, unnormalized, numValues, [] (auto x) { return simd::sub (simd::broadcast<decltype (x)> (1.0f), x); });
+            melatonin::convertFrom0to1 (range, unnormalized, unnormalized, numValues);
+        }
+
+        void convertTo0to1 (const float* unnormalized, float* normalized, int numValues) const noexcept
+        {
+            melatonin::convertTo0to1 (range, unnormalized, normalized, numValues);
+            simd::apply (normalized, normalized, numValues, [] (auto x) { return simd::sub (simd::broadcast<decltype (x)> (1.0f), x); });
+        }
+
+        [[nodiscard]] constexpr float getStart() const noexcept { return range.getStart(); }
+        [[nodiscard]] constexpr float getEnd() const noexcept { return range.getEnd(); }
+        [[nodiscard]] constexpr const RangeType& getRange() const noexcept { return range; }
+
+        // The wrapped range's converters with the 1 - x, so they're no bigger than its own
+        template <typename Callback, typename WrappedRange = RangeType, std::enable_if_t<hasConverters<WrappedRange>::value, int> = 0>
+        auto withConverters (Callback&& callback) const
+        {
+            return range.withConverters ([&] (auto from0to1, auto to0to1) {
+                return callback ([from0to1] (float rangeStart, float rangeEnd, float normalized) { return from0to1 (rangeStart, rangeEnd, 1.0f - normalized); },
+                    [to0to1] (float rangeStart, float rangeEnd, float unnormalized) { return 1.0f - to0to1 (rangeStart, rangeEnd, unnormalized); });
+            });
+        }
+
+        operator juce::NormalisableRange<float>() const { return toNormalisableRange (*this); }
+
+    private:
+        RangeType range;
+    };
+
+    // Short factories for declaring ranges as constants
+    //
+    //    constexpr auto release = melatonin::log (0.0f, 15.0f, 6.0f);
+    //    constexpr std::array<melatonin::LogRange, 3> envelope { melatonin::log (0.0f, 5.0f), melatonin::log (0.0f, 10.0f), release };
+    //
+    // The exponent derived constants are evaluated by the compiler, so there's no setup or heap use at runtime.
+    // The conversions themselves still happen at runtime (other than for linear and int ranges, which are constexpr too).
+    [[nodiscard]] constexpr LinearRange linear (float start, float end) noexcept
+    {
+        return { start, end };
+    }
+
+    [[nodiscard]] constexpr LogRange log (float logStart, float logEnd, float exponent = 6.0f, Accuracy accuracy = Accuracy::exact) noexcept
+    {
+        return { logStart, logEnd, exponent, accuracy };
+    }
+
+    [[nodiscard]] constexpr LogRangeWithLinearStart logWithLinearStart (float logStart, float logEnd, float exponent, float unnormalizedBreakpoint, float breakpointOnSlider = 0.25f, Accuracy accuracy = Accuracy::exact) noexcept
+    {
+        return { logStart, logEnd, exponent, unnormalizedBreakpoint, breakpointOnSlider, accuracy };
+    }
+
+    [[nodiscard]] constexpr DecibelRange decibels (float minimum, float maximum, Accuracy accuracy = Accuracy::exact) noexcept
+    {
+        return { minimum, maximum, accuracy };
+    }
+
+    [[nodiscard]] constexpr HarmonicDecibelRange decibelsForHarmonic (size_t harmonicNumber, float minimum = -100.f, Accuracy accuracy = Accuracy::exact) noexcept
+    {
+        return HarmonicDecibelRange (harmonicNumber, minimum, accuracy);
+    }
+
+    [[nodiscard]] constexpr IntRangeWithMidPoint intWithMidPoint (int min, int max, int midpoint) noexcept
+    {
+        return { min, max, midpoint };
+    }
+
+    template <typename RangeType>
+    [[nodiscard]] constexpr Reversed<RangeType> reversed (const RangeType& range) noexcept
+    {
+        return Reversed<RangeType> (range);
+    }
+}
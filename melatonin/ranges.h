@@ -1,16 +1,34 @@
 #pragma once
 
+// Every factory is a template on FloatType, which defaults to float.
+// For double precision processing or offline rendering, ask for a juce::NormalisableRange<double>:
+//
+//    auto release = logarithmicRange<double> (0.0, 15.0);
+//
+// The arguments don't take part in deducing FloatType, so existing calls that mix float and int arguments still compile.
+namespace melatonin
+{
+    template <typename T>
+    struct TypeIdentity
+    {
+        using type = T;
+    };
 
-static inline juce::NormalisableRange<float> linearRange (const float start, const float end)
+    template <typename T>
+    using NonDeduced = typename TypeIdentity<T>::type;
+}
+
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> linearRange (const melatonin::NonDeduced<FloatType> start, const melatonin::NonDeduced<FloatType> end)
 {
     return {
         start, end,
         // In all the following, "start" and "end" describe the unnormalized range
         // for example 0 to 15 or 0 to 100.
-        [=] (const float, const float, const float normalised) {
+        [=] (const FloatType, const FloatType, const FloatType normalised) {
             return start + normalised * (end - start);
         },
-        [=] (const float, const float, const float unnormalised) {
+        [=] (const FloatType, const FloatType, const FloatType unnormalised) {
             return (unnormalised - start) / (end - start);
         }
     };
@@ -21,17 +39,20 @@ static inline juce::NormalisableRange<float> linearRange (const float start, con
 // The exponent controls how exponential the curve is,
 // Around a value of 6, halfway on a knob is about .15
 // This value is "k" in the desmos link
-static inline juce::NormalisableRange<float> logarithmicRange (const float logStart, const float logEnd, const float exponent = 6.0f)
+//
+// Pass Accuracy::fast or Accuracy::fastest to swap std::exp2 and std::log2 for the approximations in fast_math.h
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> logarithmicRange (const melatonin::NonDeduced<FloatType> logStart, const melatonin::NonDeduced<FloatType> logEnd, const melatonin::NonDeduced<FloatType> exponent = 6, const melatonin::Accuracy accuracy = melatonin::Accuracy::exact)
 {
     return {
         logStart, logEnd,
         // In all the following, "start" and "end" describe the unnormalized range
         // for example 0 to 15 or 0 to 100.
-        [=] (const float start, const float end, const float normalised) {
-            return start + (std::exp2 (normalised * exponent) - 1) * (end - start) / (std::exp2 (exponent) - 1);
+        [=] (const FloatType start, const FloatType end, const FloatType normalised) {
+            return start + (melatonin::fastmath::exp2 (normalised * exponent, accuracy) - 1) * (end - start) / (std::exp2 (exponent) - 1);
         },
-        [=] (const float start, const float end, const float unnormalised) {
-            return std::log2 (((unnormalised - start) / (end - start) * (std::exp2 (exponent) - 1)) + 1) / exponent;
+        [=] (const FloatType start, const FloatType end, const FloatType unnormalised) {
+            return melatonin::fastmath::log2 (((unnormalised - start) / (end - start) * (std::exp2 (exponent) - 1)) + 1, accuracy) / exponent;
         }
     };
 }
@@ -40,7 +61,8 @@ static inline juce::NormalisableRange<float> logarithmicRange (const float logSt
 // for example see lots of detail in the 0-30ms range of a 20-second slider
 // this will basically plop a linear range in front of a compressed exponential range, bunching the exponential range up
 // https://www.desmos.com/calculator/lz92tpns3b
-static inline juce::NormalisableRange<float> logarithmicRangeWithLinearStart (const float logStart, const float logEnd, const float exponent, const float unnormalizedBreakpoint, const float breakpointOnSlider=0.25f)
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> logarithmicRangeWithLinearStart (const melatonin::NonDeduced<FloatType> logStart, const melatonin::NonDeduced<FloatType> logEnd, const melatonin::NonDeduced<FloatType> exponent, const melatonin::NonDeduced<FloatType> unnormalizedBreakpoint, const melatonin::NonDeduced<FloatType> breakpointOnSlider = FloatType (0.25), const melatonin::Accuracy accuracy = melatonin::Accuracy::exact)
 {
     jassert (unnormalizedBreakpoint >= logStart);
 
@@ -48,75 +70,77 @@ static inline juce::NormalisableRange<float> logarithmicRangeWithLinearStart (co
         logStart, logEnd,
         // In all the following, "start" and "end" describe the unnormalized range
         // for example 0 to 15 or 0 to 100.
-        [=] (const float start, const float end, const float normalizedValue) {
+        [=] (const FloatType start, const FloatType end, const FloatType normalizedValue) {
 
             if (normalizedValue < breakpointOnSlider)
             {
                 // how close are we to the inflection point * available linear range
                 return (normalizedValue / breakpointOnSlider) * (unnormalizedBreakpoint - start);
             }
-            const auto normalizedX = (normalizedValue - breakpointOnSlider)/(1.0f - breakpointOnSlider);
-            return unnormalizedBreakpoint + (std::exp2 (normalizedX * exponent) - 1) * (end - unnormalizedBreakpoint) / (std::exp2 (exponent) - 1);
+            const auto normalizedX = (normalizedValue - breakpointOnSlider)/(1 - breakpointOnSlider);
+            return unnormalizedBreakpoint + (melatonin::fastmath::exp2 (normalizedX * exponent, accuracy) - 1) * (end - unnormalizedBreakpoint) / (std::exp2 (exponent) - 1);
         },
-        [=] (const float, const float end, const float unnormalizedValue) {
+        [=] (const FloatType, const FloatType end, const FloatType unnormalizedValue) {
             if (unnormalizedValue < unnormalizedBreakpoint)
             {
                 return (unnormalizedValue / unnormalizedBreakpoint) * breakpointOnSlider;
             }
-            return breakpointOnSlider + (1.0f - breakpointOnSlider) * std::log2 (((unnormalizedValue - unnormalizedBreakpoint) / (end - unnormalizedBreakpoint) * (std::exp2 (exponent) - 1)) + 1) / exponent;
+            return breakpointOnSlider + (1 - breakpointOnSlider) * melatonin::fastmath::log2 (((unnormalizedValue - unnormalizedBreakpoint) / (end - unnormalizedBreakpoint) * (std::exp2 (exponent) - 1)) + 1, accuracy) / exponent;
         }
     };
 }
 
-static inline juce::NormalisableRange<float> reversedLogarithmicRange (float logStart, float logEnd, float exponent = 6.0f)
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> reversedLogarithmicRange (melatonin::NonDeduced<FloatType> logStart, melatonin::NonDeduced<FloatType> logEnd, melatonin::NonDeduced<FloatType> exponent = 6, melatonin::Accuracy accuracy = melatonin::Accuracy::exact)
 {
     return {
         logStart, logEnd,
         // In all the following, "start" and "end" describe the unnormalized range
         // for example 0 to 15 or 0 to 100.
-        [=] (const float start, const float end, const float normalised) {
-            return start + (std::exp2 ((1.0 - normalised) * exponent) - 1) * (end - start) / (std::exp2 (exponent) - 1);
+        [=] (const FloatType start, const FloatType end, const FloatType normalised) {
+            return start + (melatonin::fastmath::exp2 ((1 - normalised) * exponent, accuracy) - 1) * (end - start) / (std::exp2 (exponent) - 1);
         },
-        [=] (const float start, const float end, float unnormalised) {
-            return 1.0f - std::log2 (((unnormalised - start) / (end - start) * (std::exp2 (exponent) - 1)) + 1) / exponent;
+        [=] (const FloatType start, const FloatType end, FloatType unnormalised) {
+            return 1 - melatonin::fastmath::log2 (((unnormalised - start) / (end - start) * (std::exp2 (exponent) - 1)) + 1, accuracy) / exponent;
         }
     };
 }
 
-// juce::AudioParameterInt doesn't have normalizable ranges, super annoying, but that's why this is float
-static inline juce::NormalisableRange<float> intRangeWithMidPoint (int min, int max, int midpoint)
+// juce::AudioParameterInt doesn't have normalizable ranges, super annoying, but that's why this is float (or double)
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> intRangeWithMidPoint (int min, int max, int midpoint)
 {
-    const float linearSkew = 2 * (((float) midpoint - (float) min) / ((float) max - (float) min));
+    const FloatType linearSkew = 2 * (((FloatType) midpoint - (FloatType) min) / ((FloatType) max - (FloatType) min));
 
-    auto range = juce::NormalisableRange<float> {
-        (float) min, (float) max,
+    auto range = juce::NormalisableRange<FloatType> {
+        (FloatType) min, (FloatType) max,
 
         // from0to1
-        [=] (const float start, const float end, const float normalized) {
+        [=] (const FloatType start, const FloatType end, const FloatType normalized) {
             if (normalized <= 0.5)
                 return juce::jlimit (start, end, normalized * linearSkew * (end - start) + start);
             else
-                return juce::jlimit (start, end, (float) midpoint + (normalized - 0.5f) * 2 * (end - (float) midpoint));
+                return juce::jlimit (start, end, (FloatType) midpoint + (normalized - FloatType (0.5)) * 2 * (end - (FloatType) midpoint));
         },
 
         // to0to1
-        [=] (const float start, const float end, const float unnormalized) {
-            if (unnormalized <= (float) midpoint)
+        [=] (const FloatType start, const FloatType end, const FloatType unnormalized) {
+            if (unnormalized <= (FloatType) midpoint)
             {
-                return juce::jlimit (0.0f, 1.0f, (unnormalized - start) / ((float) midpoint - start) / 2);
+                return juce::jlimit (FloatType (0), FloatType (1), (unnormalized - start) / ((FloatType) midpoint - start) / 2);
             }
             else
             {
-                return juce::jlimit (0.0f, 1.0f, 0.5f + (unnormalized - (float) midpoint) / (end - (float) midpoint) / 2.0f);
+                return juce::jlimit (FloatType (0), FloatType (1), FloatType (0.5) + (unnormalized - (FloatType) midpoint) / (end - (FloatType) midpoint) / 2);
             }
         },
 
         // snap
-        [] (const float start, const float end, const float v) { return (float) juce::roundToInt (juce::jlimit (start, end, v)); }
+        melatonin::SnapToInt()
     };
 
-    range.setSkewForCentre ((float) midpoint);
-    range.interval = 1.0f;
+    range.setSkewForCentre ((FloatType) midpoint);
+    range.interval = 1;
     return range;
 }
 
@@ -131,52 +155,51 @@ static inline juce::NormalisableRange<float> intRangeWithMidPoint (int min, int
  *
  *  https://forum.juce.com/t/decibels-in-normalisablerange-using-lambdas/26379/6
  */
-static inline juce::NormalisableRange<float> decibelRangeForHarmonic (size_t harmonicNumber, float minimum = -100.f)
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> decibelRangeForHarmonic (size_t harmonicNumber, melatonin::NonDeduced<FloatType> minimum = -100, melatonin::Accuracy accuracy = melatonin::Accuracy::exact)
 {
-    jassert (minimum < 0.0f);
-    float maxGainForHarmonic = 1.0f / (float) harmonicNumber;
+    jassert (minimum < 0);
+    FloatType maxGainForHarmonic = 1 / (FloatType) harmonicNumber;
     return {
         minimum,
         // The max gain for any given harmonic is 1/f
         juce::Decibels::gainToDecibels (maxGainForHarmonic, minimum),
 
         // convertFrom0to1
-        [=] (float min, float /*max*/, float normalizedGain) {
-            return juce::Decibels::gainToDecibels<float> (normalizedGain / (float) harmonicNumber, min);
+        [=] (FloatType min, FloatType /*max*/, FloatType normalizedGain) {
+            return melatonin::fastmath::gainToDecibels (normalizedGain / (FloatType) harmonicNumber, min, accuracy);
         },
 
         // convertTo0to1
-        [=] (float min, float /*max*/, float dB) {
+        [=] (FloatType min, FloatType /*max*/, FloatType dB) {
             // This can sometimes result in a number just barely above 1.0f
-            return juce::jmin (1.0f, (float) harmonicNumber * juce::Decibels::decibelsToGain (dB, min));
+            return juce::jmin (FloatType (1), (FloatType) harmonicNumber * melatonin::fastmath::decibelsToGain (dB, min, accuracy));
         }
     };
 }
 
 // This is a generic gain <-> decibel range
-static inline juce::NormalisableRange<float> decibelRange()
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> decibelRange (melatonin::Accuracy accuracy = melatonin::Accuracy::exact)
 {
-    return decibelRangeForHarmonic (1);
+    return decibelRangeForHarmonic<FloatType> (1, -100, accuracy);
 }
 
-static inline juce::NormalisableRange<float> decibelRange (float minimum, float maximum)
+// 20 * log10 (minAmp * (maxAmp / minAmp)^x) works out to minimum + x * (maximum - minimum),
+// so this range is linear in dB and needs no pow or log at all (and has no accuracy to pick)
+template <typename FloatType = float>
+static inline juce::NormalisableRange<FloatType> decibelRange (melatonin::NonDeduced<FloatType> minimum, melatonin::NonDeduced<FloatType> maximum)
 {
-    jassert (minimum < 0.0f);
+    jassert (minimum < 0);
 
     return {
         minimum,
         maximum,
-        [=] (float min, float max, float normalized) {
-            auto minAmp = std::pow (10.0f, min / 20.0f);
-            auto maxAmp = std::pow (10.0f, max / 20.0f);
-            auto amp    = minAmp * std::pow (maxAmp / minAmp, normalized);
-            return 20.0f * std::log10 (amp);
+        [] (FloatType min, FloatType max, FloatType normalized) {
+            return min + normalized * (max - min);
         },
-        [=] (float min, float max, float dB) {
-            auto minAmp = std::pow (10.0f, min / 20.0f);
-            auto maxAmp = std::pow (10.0f, max / 20.0f);
-            auto amp    = std::pow (10.0f, dB / 20.0f);
-            return std::log (amp / minAmp) / std::log (maxAmp / minAmp);
+        [] (FloatType min, FloatType max, FloatType dB) {
+            return (dB - min) / (max - min);
         }
     };
 }
@@ -0,0 +1,215 @@
+#pragma once
+
+// Just enough 4-wide SIMD for the kernels in this module
+//
+// Kernels are written once as templates and get instantiated for a single float
+// (to handle the leftover values at the end of a block) and for the native 4 float register.
+// SSE2 is the baseline on every x86_64 target, NEON on every arm64 one.
+// Anything else just runs the scalar version.
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define MELATONIN_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define MELATONIN_SIMD_NEON 1
+#endif
+
+namespace melatonin::simd
+{
+    // scalar
+    template <typename Vec>
+    inline Vec broadcast (float value) noexcept;
+
+    template <>
+    inline float broadcast (float value) noexcept { return value; }
+
+    inline float add (float a, float b) noexcept { return a + b; }
+    inline float sub (float a, float b) noexcept { return a - b; }
+    inline float mul (float a, float b) noexcept { return a * b; }
+    inline float min (float a, float b) noexcept { return b < a ? b : a; }
+    inline float max (float a, float b) noexcept { return a < b ? b : a; }
+    inline float div (float a, float b) noexcept { return a / b; }
+    inline float floor (float a) noexcept { return std::floor (a); }
+
+    // like juce::roundToInt, halfway values go to the even neighbor
+    inline float roundHalfToEven (float a) noexcept { return std::nearbyint (a); }
+
+    // selects b where a > threshold, else a
+    inline float selectAbove (float a, float threshold, float b) noexcept { return a > threshold ? b : a; }
+
+    // per lane comparisons, for picking between two results with select
+    inline bool isBelow (float a, float b) noexcept { return a < b; }
+    inline bool isAtOrBelow (float a, float b) noexcept { return a <= b; }
+    inline float select (bool mask, float whereTrue, float whereFalse) noexcept { return mask ? whereTrue : whereFalse; }
+
+    inline void store (float* destination, float a) noexcept { *destination = a; }
+    inline void store (int32_t* destination, int32_t a) noexcept { *destination = a; }
+
+    inline int32_t truncateToInt (float a) noexcept { return (int32_t) a; }
+    inline float toFloat (int32_t a) noexcept { return (float) a; }
+    inline int32_t addInt (int32_t a, int32_t b) noexcept { return a + b; }
+    inline int32_t subInt (int32_t a, int32_t b) noexcept { return a - b; }
+    inline int32_t broadcastInt (float, int32_t value) noexcept { return value; }
+
+    template <int bits>
+    inline int32_t shiftLeft (int32_t a) noexcept { return (int32_t) ((uint32_t) a << bits); }
+
+    template <int bits>
+    inline int32_t shiftRightArithmetic (int32_t a) noexcept { return a >> bits; }
+
+    inline int32_t asInt (float a) noexcept
+    {
+        int32_t result;
+        std::memcpy (&result, &a, sizeof (result));
+        return result;
+    }
+
+    inline float asFloat (int32_t a) noexcept
+    {
+        float result;
+        std::memcpy (&result, &a, sizeof (result));
+        return result;
+    }
+
+#if MELATONIN_SIMD_SSE2
+    #define MELATONIN_SIMD 1
+    using Float4 = __m128;
+
+    template <>
+    inline __m128 broadcast (float value) noexcept { return _mm_set1_ps (value); }
+
+    inline __m128 load (const float* source) noexcept { return _mm_loadu_ps (source); }
+    inline void store (float* destination, __m128 a) noexcept { _mm_storeu_ps (destination, a); }
+    inline void store (int32_t* destination, __m128i a) noexcept { _mm_storeu_si128 (reinterpret_cast<__m128i*> (destination), a); }
+
+    inline __m128 add (__m128 a, __m128 b) noexcept { return _mm_add_ps (a, b); }
+    inline __m128 sub (__m128 a, __m128 b) noexcept { return _mm_sub_ps (a, b); }
+    inline __m128 mul (__m128 a, __m128 b) noexcept { return _mm_mul_ps (a, b); }
+    inline __m128 div (__m128 a, __m128 b) noexcept { return _mm_div_ps (a, b); }
+    inline __m128 min (__m128 a, __m128 b) noexcept { return _mm_min_ps (a, b); }
+    inline __m128 max (__m128 a, __m128 b) noexcept { return _mm_max_ps (a, b); }
+
+    inline __m128 selectAbove (__m128 a, __m128 threshold, __m128 b) noexcept
+    {
+        const auto mask = _mm_cmpgt_ps (a, threshold);
+        return _mm_or_ps (_mm_and_ps (mask, b), _mm_andnot_ps (mask, a));
+    }
+
+    inline __m128 isBelow (__m128 a, __m128 b) noexcept { return _mm_cmplt_ps (a, b); }
+    inline __m128 isAtOrBelow (__m128 a, __m128 b) noexcept { return _mm_cmple_ps (a, b); }
+    inline __m128 select (__m128 mask, __m128 whereTrue, __m128 whereFalse) noexcept
+    {
+        return _mm_or_ps (_mm_and_ps (mask, whereTrue), _mm_andnot_ps (mask, whereFalse));
+    }
+
+    inline __m128i truncateToInt (__m128 a) noexcept { return _mm_cvttps_epi32 (a); }
+    inline __m128 toFloat (__m128i a) noexcept { return _mm_cvtepi32_ps (a); }
+    inline __m128i addInt (__m128i a, __m128i b) noexcept { return _mm_add_epi32 (a, b); }
+    inline __m128i subInt (__m128i a, __m128i b) noexcept { return _mm_sub_epi32 (a, b); }
+    inline __m128i broadcastInt (__m128, int32_t value) noexcept { return _mm_set1_epi32 (value); }
+
+    template <int bits>
+    inline __m128i shiftLeft (__m128i a) noexcept { return _mm_slli_epi32 (a, bits); }
+
+    template <int bits>
+    inline __m128i shiftRightArithmetic (__m128i a) noexcept { return _mm_srai_epi32 (a, bits); }
+
+    inline __m128i asInt (__m128 a) noexcept { return _mm_castps_si128 (a); }
+    inline __m128 asFloat (__m128i a) noexcept { return _mm_castsi128_ps (a); }
+
+    // SSE2 has no floor, so truncate and step down where that rounded up
+    // From 2^23 up every float is already whole (and past 2^31 won't fit the int), so those pass through
+    inline __m128 floor (__m128 a) noexcept
+    {
+        const auto truncated = _mm_cvtepi32_ps (_mm_cvttps_epi32 (a));
+        const auto floored = _mm_sub_ps (truncated, _mm_and_ps (_mm_cmpgt_ps (truncated, a), _mm_set1_ps (1.0f)));
+        const auto fitsInt = _mm_cmplt_ps (_mm_andnot_ps (_mm_set1_ps (-0.0f), a), _mm_set1_ps (8388608.0f));
+        return _mm_or_ps (_mm_and_ps (fitsInt, floored), _mm_andnot_ps (fitsInt, a));
+    }
+
+    // cvtps rounds with the current rounding mode, which is to nearest even unless someone changed it
+    inline __m128 roundHalfToEven (__m128 a) noexcept { return _mm_cvtepi32_ps (_mm_cvtps_epi32 (a)); }
+#elif MELATONIN_SIMD_NEON
+    #define MELATONIN_SIMD 1
+    using Float4 = float32x4_t;
+
+    template <>
+    inline float32x4_t broadcast (float value) noexcept { return vdupq_n_f32 (value); }
+
+    inline float32x4_t load (const float* source) noexcept { return vld1q_f32 (source); }
+    inline void store (float* destination, float32x4_t a) noexcept { vst1q_f32 (destination, a); }
+    inline void store (int32_t* destination, int32x4_t a) noexcept { vst1q_s32 (destination, a); }
+
+    inline float32x4_t add (float32x4_t a, float32x4_t b) noexcept { return vaddq_f32 (a, b); }
+    inline float32x4_t sub (float32x4_t a, float32x4_t b) noexcept { return vsubq_f32 (a, b); }
+    inline float32x4_t mul (float32x4_t a, float32x4_t b) noexcept { return vmulq_f32 (a, b); }
+    inline float32x4_t min (float32x4_t a, float32x4_t b) noexcept { return vminq_f32 (a, b); }
+    inline float32x4_t max (float32x4_t a, float32x4_t b) noexcept { return vmaxq_f32 (a, b); }
+
+    inline float32x4_t selectAbove (float32x4_t a, float32x4_t threshold, float32x4_t b) noexcept
+    {
+        return vbslq_f32 (vcgtq_f32 (a, threshold), b, a);
+    }
+
+    inline uint32x4_t isBelow (float32x4_t a, float32x4_t b) noexcept { return vcltq_f32 (a, b); }
+    inline uint32x4_t isAtOrBelow (float32x4_t a, float32x4_t b) noexcept { return vcleq_f32 (a, b); }
+    inline float32x4_t select (uint32x4_t mask, float32x4_t whereTrue, float32x4_t whereFalse) noexcept { return vbslq_f32 (mask, whereTrue, whereFalse); }
+
+    inline int32x4_t truncateToInt (float32x4_t a) noexcept { return vcvtq_s32_f32 (a); }
+    inline float32x4_t toFloat (int32x4_t a) noexcept { return vcvtq_f32_s32 (a); }
+    inline int32x4_t addInt (int32x4_t a, int32x4_t b) noexcept { return vaddq_s32 (a, b); }
+    inline int32x4_t subInt (int32x4_t a, int32x4_t b) noexcept { return vsubq_s32 (a, b); }
+    inline int32x4_t broadcastInt (float32x4_t, int32_t value) noexcept { return vdupq_n_s32 (value); }
+
+    template <int bits>
+    inline int32x4_t shiftLeft (int32x4_t a) noexcept { return vshlq_n_s32 (a, bits); }
+
+    template <int bits>
+    inline int32x4_t shiftRightArithmetic (int32x4_t a) noexcept { return vshrq_n_s32 (a, bits); }
+
+    inline int32x4_t asInt (float32x4_t a) noexcept { return vreinterpretq_s32_f32 (a); }
+    inline float32x4_t asFloat (int32x4_t a) noexcept { return vreinterpretq_f32_s32 (a); }
+
+    // from 2^23 up every float is already whole (and past 2^31 won't fit the int), so those pass through
+    inline float32x4_t floor (float32x4_t a) noexcept
+    {
+        const auto truncated = vcvtq_f32_s32 (vcvtq_s32_f32 (a));
+        const auto floored = vsubq_f32 (truncated, vreinterpretq_f32_u32 (vandq_u32 (vcgtq_f32 (truncated, a), vreinterpretq_u32_f32 (vdupq_n_f32 (1.0f)))));
+        return vbslq_f32 (vcltq_f32 (vabsq_f32 (a), vdupq_n_f32 (8388608.0f)), floored, a);
+    }
+
+    #if defined(__aarch64__) || defined(_M_ARM64)
+    inline float32x4_t div (float32x4_t a, float32x4_t b) noexcept { return vdivq_f32 (a, b); }
+    inline float32x4_t roundHalfToEven (float32x4_t a) noexcept { return vrndnq_f32 (a); }
+    #else
+    // 32 bit arm has neither, so go a lane at a time to get the same results as the scalar versions
+    template <typename Operation>
+    inline float32x4_t perLane (float32x4_t a, float32x4_t b, Operation&& operation) noexcept
+    {
+        float lanesA[4], lanesB[4];
+        vst1q_f32 (lanesA, a);
+        vst1q_f32 (lanesB, b);
+        for (int i = 0; i < 4; ++i)
+            lanesA[i] = operation (lanesA[i], lanesB[i]);
+        return vld1q_f32 (lanesA);
+    }
+
+    inline float32x4_t div (float32x4_t a, float32x4_t b) noexcept { return perLane (a, b, [] (float x, float y) { return x / y; }); }
+    inline float32x4_t roundHalfToEven (float32x4_t a) noexcept { return perLane (a, a, [] (float x, float) { return std::nearbyint (x); }); }
+    #endif
+#endif
+
+    // Runs a kernel over a block, 4 at a time where possible
+    // Source and destination may be the same
+    template <typename Kernel>
+    inline void apply (const float* source, float* destination, int numValues, Kernel&& kernel) noexcept
+    {
+        int i = 0;
+#if MELATONIN_SIMD
+        for (; i + 4 <= numValues; i += 4)
+            store (destination + i, kernel (load (source + i)));
+#endif
+        for (; i < numValues; ++i)
+            destination[i] = kernel (source[i]);
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+// Smooths a parameter along its range instead of in a straight line
+//
+// juce::SmoothedValue ramps linearly between unnormalized values. For a logarithmicRange release time
+// or a decibelRange gain that's the wrong curve: most of the ramp is spent in the part of the range you can barely hear.
+// RangeSmoother ramps the normalized value instead, so it moves the way the knob does (for log and decibel ranges,
+// that's the log domain), and turns a whole block back into unnormalized values with one block conversion.
+//
+//    melatonin::RangeSmoother<melatonin::LogRange> release { melatonin::LogRange (0.0f, 15.0f) };
+//    release.reset (sampleRate, 0.05);
+//
+//    // in processBlock
+//    release.setTargetValue (releaseParameter->get());
+//    if (release.isSmoothing())
+//        release.process (releaseValues, numSamples);
+//    else
+//        useTheSameValueForTheWholeBlock (release.getCurrentValue());
+//
+// Works with the types in range_types.h (and LookupTableRange), which convert a block at a time,
+// or any juce::NormalisableRange<float> from ranges.h, which falls back to converting one value at a time.
+namespace melatonin
+{
+    template <typename RangeType>
+    class RangeSmoother
+    {
+    public:
+        explicit RangeSmoother (const RangeType& rangeToUse, float initialValue = 0.0f)
+            : range (rangeToUse)
+        {
+            setCurrentAndTargetValue (initialValue);
+        }
+
+        // Like juce::SmoothedValue::reset, this stops any ramp in progress
+        void reset (double sampleRate, double rampLengthInSeconds) noexcept
+        {
+            jassert (sampleRate > 0 && rampLengthInSeconds >= 0);
+            stepsToTarget = (int) std::floor (rampLengthInSeconds * sampleRate);
+            setCurrentAndTargetValue (targetValue);
+        }
+
+        void setCurrentAndTargetValue (float unnormalized) noexcept
+        {
+            lastTargetSet = unnormalized;
+            target = current = range.convertTo0to1 (unnormalized);
+            targetValue = range.convertFrom0to1 (target);
+            step = 0.0f;
+            countdown = 0;
+        }
+
+        // Cheap to call every block, nothing happens (not even a conversion) unless the target moved
+        void setTargetValue (float unnormalized) noexcept
+        {
+            if (unnormalized == lastTargetSet)
+                return;
+
+            lastTargetSet = unnormalized;
+            const auto normalized = range.convertTo0to1 (unnormalized);
+            if (normalized == target)
+                return;
+
+            if (stepsToTarget <= 0)
+            {
+                setCurrentAndTargetValue (unnormalized);
+                return;
+            }
+
+            target = normalized;
+            targetValue = range.convertFrom0to1 (target);
+            countdown = stepsToTarget;
+            step = (target - current) / (float) countdown;
+        }
+
+        [[nodiscard]] bool isSmoothing() const noexcept { return countdown > 0; }
+
+        [[nodiscard]] float getTargetValue() const noexcept { return targetValue; }
+
+        // Converts, so prefer process for more than the odd value while smoothing
+        [[nodiscard]] float getCurrentValue() const noexcept
+        {
+            return isSmoothing() ? range.convertFrom0to1 (current) : targetValue;
+        }
+
+        [[nodiscard]] float getNextValue() noexcept
+        {
+            if (! isSmoothing())
+                return targetValue;
+
+            advance (1);
+            return range.convertFrom0to1 (current);
+        }
+
+        // Fills destination with the next numSamples unnormalized values
+        // Once the ramp is over it's just a fill with the target, no conversions
+        void process (float* destination, int numSamples) noexcept
+        {
+            if (! isSmoothing())
+            {
+                juce::FloatVectorOperations::fill (destination, targetValue, numSamples);
+                return;
+            }
+
+            // the normalized ramp, then the target for whatever is left of the block
+            const auto numRamping = std::min (numSamples, countdown);
+            for (int i = 0; i < numRamping; ++i)
+                destination[i] = current + step * (float) (i + 1);
+            if (numRamping == countdown)
+                destination[numRamping - 1] = target;
+
+            convertFrom0to1 (range, destination, destination, numRamping);
+
+            juce::FloatVectorOperations::fill (destination + numRamping, targetValue, numSamples - numRamping);
+            advance (numRamping);
+        }
+
+        // Moves the ramp along without producing any values
+        void skip (int numSamples) noexcept
+        {
+            advance (std::min (numSamples, countdown));
+        }
+
+        [[nodiscard]] const RangeType& getRange() const noexcept { return range; }
+
+    private:
+        RangeType range;
+
+        // normalized, the ramp runs from current to target in steps
+        float current = 0.0f, target = 0.0f, step = 0.0f;
+
+        // the unnormalized target, so an idle smoother never converts
+        float targetValue = 0.0f;
+
+        // exactly what setTargetValue was last given, which can be out of the range (targetValue is clamped)
+        float lastTargetSet = 0.0f;
+        int countdown = 0, stepsToTarget = 0;
+
+        void advance (int numSamples) noexcept
+        {
+            countdown -= numSamples;
+            current = countdown <= 0 ? target : current + step * (float) numSamples;
+            countdown = std::max (countdown, 0);
+        }
+    };
+}
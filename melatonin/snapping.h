@@ -0,0 +1,198 @@
+#pragma once
+
+// Snapping for juce::NormalisableRange, with a block version of each
+//
+// Any of these can snap a range, withSnapping gives it one (and the interval to match):
+//
+//    auto steps = melatonin::withSnapping (linearRange (0.0f, 1.0f), melatonin::SnapToInterval<> { 0.25f });
+//    auto division = melatonin::withSnapping (linearRange (0.0f, 1.0f), melatonin::SnapToValues<> ({ 1.0f / 16, 1.0f / 8, 1.0f / 4, 1.0f / 2, 1.0f }));
+//
+// JUCE snaps one value at a time through the std::function. When randomizing or morphing lots of stepped values,
+// call the block version on the snapping function itself:
+//
+//    const auto toDivisions = melatonin::SnapToValues<> ({ 1.0f / 16, 1.0f / 8, 1.0f / 4, 1.0f / 2, 1.0f });
+//    toDivisions (range.start, range.end, randomValues, snappedValues, numValues);
+namespace melatonin
+{
+    // What NormalisableRange does by itself: round to the nearest step from start, then clamp to the range
+    // An interval of 0 only clamps
+    template <typename FloatType = float>
+    struct SnapToInterval
+    {
+        FloatType interval = 0;
+
+        FloatType operator() (FloatType start, FloatType end, FloatType value) const noexcept
+        {
+            if (interval > 0)
+                value = start + interval * std::floor ((value - start) / interval + FloatType (0.5));
+
+            return (value <= start || end <= start) ? start : (value >= end ? end : value);
+        }
+
+        void operator() (FloatType start, FloatType end, const FloatType* values, FloatType* snapped, int numValues) const noexcept
+        {
+            if constexpr (std::is_same_v<FloatType, float>)
+            {
+                if (end > start)
+                {
+                    const auto step = interval;
+                    if (step > 0)
+                    {
+                        // clamping first keeps far out of range values from making huge step counts
+                        return simd::apply (values, snapped, numValues, [=] (auto value) {
+                            using Vec = decltype (value);
+                            value = simd::min (simd::max (value, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (end));
+                            const auto steps = simd::floor (simd::add (simd::div (simd::sub (value, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (step)), simd::broadcast<Vec> (0.5f)));
+                            value = simd::add (simd::broadcast<Vec> (start), simd::mul (simd::broadcast<Vec> (step), steps));
+                            return simd::min (simd::max (value, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (end));
+                        });
+                    }
+
+                    return simd::apply (values, snapped, numValues, [=] (auto value) {
+                        using Vec = decltype (value);
+                        return simd::min (simd::max (value, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (end));
+                    });
+                }
+            }
+
+            for (int i = 0; i < numValues; ++i)
+                snapped[i] = (*this) (start, end, values[i]);
+        }
+    };
+
+    // Clamps, then rounds to the nearest whole number (halfway goes to even, like juce::roundToInt)
+    struct SnapToInt
+    {
+        template <typename FloatType>
+        FloatType operator() (FloatType start, FloatType end, FloatType value) const noexcept
+        {
+            return (FloatType) juce::roundToInt (juce::jlimit (start, end, value));
+        }
+
+        template <typename FloatType>
+        void operator() (FloatType start, FloatType end, const FloatType* values, FloatType* snapped, int numValues) const noexcept
+        {
+            if constexpr (std::is_same_v<FloatType, float>)
+            {
+                return simd::apply (values, snapped, numValues, [=] (auto value) {
+                    using Vec = decltype (value);
+                    return simd::roundHalfToEven (simd::min (simd::max (value, simd::broadcast<Vec> (start)), simd::broadcast<Vec> (end)));
+                });
+            }
+            else
+            {
+                for (int i = 0; i < numValues; ++i)
+                    snapped[i] = (*this) (start, end, values[i]);
+            }
+        }
+    };
+
+    // Snaps to the nearest of a set of legal values, such as note divisions (halfway goes to the higher one)
+    // The range's start and end aren't used, the legal values are what you say they are
+    //
+    // The values are kept sorted in a table padded to a power of 2,
+    // so finding the nearest is always log2 (size) steps, each one a compare and a conditional move rather than a branch
+    template <typename FloatType = float>
+    class SnapToValues
+    {
+    public:
+        SnapToValues (std::initializer_list<FloatType> legalValues) : SnapToValues (std::vector<FloatType> (legalValues))
+        {
+        }
+
+        explicit SnapToValues (std::vector<FloatType> legalValues) : table (std::move (legalValues))
+        {
+            jassert (! table.empty());
+            std::sort (table.begin(), table.end());
+            table.erase (std::unique (table.begin(), table.end()), table.end());
+            numValues = table.size();
+
+            // room for at least one past the last value, so every value has a neighbor above it
+            size_t paddedSize = 2;
+            while (paddedSize < numValues + 1)
+                paddedSize *= 2;
+            table.resize (paddedSize, std::numeric_limits<FloatType>::infinity());
+        }
+
+        FloatType operator() (FloatType, FloatType, FloatType value) const noexcept { return nearest (value); }
+
+        void operator() (FloatType, FloatType, const FloatType* values, FloatType* snapped, int numValuesToSnap) const noexcept
+        {
+            for (int i = 0; i < numValuesToSnap; ++i)
+                snapped[i] = nearest (values[i]);
+        }
+
+        [[nodiscard]] size_t getNumValues() const noexcept { return numValues; }
+        [[nodiscard]] FloatType getValue (size_t index) const noexcept { return table[index]; }
+
+    private:
+        std::vector<FloatType> table;
+        size_t numValues = 0;
+
+        FloatType nearest (FloatType value) const noexcept
+        {
+            // keep value within the legal ones, so the search never reaches the padding (NaN goes to the first)
+            const auto first = table[0];
+            const auto last = table[numValues - 1];
+            value = first < value ? (value < last ? value : last) : first;
+
+            // the last legal value at or below value
+            size_t index = 0;
+            for (auto step = table.size() / 2; step > 0; step /= 2)
+                index = table[index + step] <= value ? index + step : index;
+
+            const auto below = table[index];
+            const auto above = table[index + 1];
+            return value - below < above - value ? below : above;
+        }
+    };
+
+    template <typename Snap, typename FloatType>
+    static inline FloatType intervalFor (const Snap& snap, FloatType otherwise) noexcept
+    {
+        if constexpr (std::is_same_v<Snap, SnapToInterval<FloatType>>)
+            return snap.interval;
+        else if constexpr (std::is_same_v<Snap, SnapToInt>)
+            return 1;
+        else
+            return otherwise;
+    }
+
+    // Gives any range one of the snapping functions above
+    // The interval is set to match, so sliders step the same way.
+    //
+    // JUCE doesn't let a range's snapping be swapped out, so this makes a new range that converts through the old one.
+    // For the factories in ranges.h that's one more std::function call per conversion, the range types don't pay it.
+    template <typename FloatType, typename Snap>
+    static inline juce::NormalisableRange<FloatType> withSnapping (const juce::NormalisableRange<FloatType>& range, Snap snap)
+    {
+        const auto interval = intervalFor (snap, range.interval);
+        juce::NormalisableRange<FloatType> snapping {
+            range.start, range.end,
+            [range] (FloatType, FloatType, FloatType normalized) { return range.convertFrom0to1 (normalized); },
+            [range] (FloatType, FloatType, FloatType unnormalized) { return range.convertTo0to1 (unnormalized); },
+            std::move (snap)
+        };
+
+        snapping.interval = interval;
+        snapping.skew = range.skew;
+        snapping.symmetricSkew = range.symmetricSkew;
+        return snapping;
+    }
+
+    // For the range types, like melatonin::LogRange
+    template <typename RangeType, typename Snap>
+    static inline juce::NormalisableRange<float> withSnapping (const RangeType& range, Snap snap)
+    {
+        const auto interval = intervalFor (snap, 0.0f);
+        juce::NormalisableRange<float> snapping {
+            range.getStart(), range.getEnd(),
+            [range] (float, float, float normalized) { return range.convertFrom0to1 (normalized); },
+            [range] (float, float, float unnormalized) { return range.convertTo0to1 (unnormalized); },
+            std::move (snap)
+        };
+
+        snapping.interval = interval;
+        return snapping;
+    }
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <optional>
+
+// A binary bank of presets, read straight from memory (or a memory mapped file) without parsing
+//
+// Previewing thousands of presets through XML and ValueTree is too slow for instant auditioning.
+// A snapshot stores a bank of presets as one packed array of normalized values, either as floats or as 16 bit integers,
+// plus a hash table from parameter ID to its column:
+//
+//    auto writer = melatonin::SnapshotWriter::create ({ "attack", "release", "cutoff" }, melatonin::SnapshotWriter::Encoding::uint16);
+//    writer->addPreset (normalizedValues);
+//    writer->writeTo (bankFile);
+//
+//    melatonin::MappedSnapshot bank (bankFile);
+//    auto cutoff = bank.indexOf ("cutoff");
+//    bank.getValues (presetIndex, cutoff, 1, melatonin::LogRange (20.0f, 20000.0f, 10.0f), &frequency);
+//
+// Opening a bank only checks the header and sizes, every lookup after that is a read from the mapped memory.
+// Plain values go through the range's block conversion (see range_types.h).
+//
+// Layout, all in the machine's byte order (a snapshot from a big endian machine fails to open on a little endian one):
+//
+//    Header                  32 bytes
+//    hash table              tableSize slots of { uint64 hash of the ID, uint32 column, uint32 unused }, empty slots have a column of ~0
+//    values                  numPresets rows of numParameters floats or uint16s, each row padded to 4 bytes
+namespace melatonin
+{
+    namespace snapshot
+    {
+        // FNV-1a, which is plenty for a few thousand parameter IDs (the writer checks for collisions)
+        static constexpr uint64_t hashID (std::string_view id) noexcept
+        {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (auto c : id)
+                hash = (hash ^ (uint8_t) c) * 0x100000001b3ull;
+            return hash;
+        }
+
+        static constexpr uint32_t magic = 0x504e534d; // "MSNP"
+        static constexpr uint16_t version = 1;
+        static constexpr uint32_t emptySlot = ~0u;
+
+        // far more than any plugin has, anything bigger in a header is a corrupt file
+        static constexpr uint32_t maxParameters = 1u << 20;
+
+        enum class Encoding : uint16_t {
+            float32, // exact
+            uint16, // half the size, normalized values are within 1 / 131070 of what was written
+        };
+
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            Encoding encoding;
+            uint32_t numParameters;
+            uint32_t numPresets;
+            uint32_t tableSize;
+            uint32_t rowSize; // in bytes, including padding
+            uint64_t unused;
+        };
+
+        struct Slot
+        {
+            uint64_t hash;
+            uint32_t column;
+            uint32_t unused;
+        };
+
+        static_assert (sizeof (Header) == 32 && sizeof (Slot) == 16, "The layout has to match on every compiler");
+
+        static constexpr uint32_t tableSizeFor (uint64_t numParameters) noexcept
+        {
+            // under half full, so probes stay short
+            uint64_t size = 16;
+            while (size < numParameters * 2 && size < (uint64_t) maxParameters * 2)
+                size *= 2;
+            return (uint32_t) size;
+        }
+
+        static constexpr uint32_t rowSizeFor (size_t numParameters, Encoding encoding) noexcept
+        {
+            const auto bytes = numParameters * (encoding == Encoding::float32 ? sizeof (float) : sizeof (uint16_t));
+            return (uint32_t) ((bytes + 3) / 4 * 4);
+        }
+    }
+
+    // Reads a snapshot from memory you own, such as a mapped file or BinaryData
+    class SnapshotView
+    {
+    public:
+        using Encoding = snapshot::Encoding;
+
+        SnapshotView() = default;
+
+        SnapshotView (const void* dataToUse, size_t sizeInBytes) noexcept
+        {
+            using namespace snapshot;
+            if (dataToUse == nullptr || sizeInBytes < sizeof (Header))
+                return;
+
+            Header header;
+            std::memcpy (&header, dataToUse, sizeof (Header));
+
+            // a table has at least 2 slots per parameter, so a count that couldn't fit is a corrupt (or truncated) file
+            if (header.numParameters > maxParameters || header.numPresets > (uint32_t) std::numeric_limits<int>::max()
+                || sizeof (Header) + (uint64_t) header.numParameters * 2 * sizeof (Slot) > sizeInBytes)
+                return;
+
+            if (header.magic != magic || header.version != version
+                || (header.encoding != Encoding::float32 && header.encoding != Encoding::uint16)
+                || header.tableSize != tableSizeFor (header.numParameters)
+                || header.rowSize != rowSizeFor (header.numParameters, header.encoding))
+                return;
+
+            const auto expectedSize = sizeof (Header) + (uint64_t) header.tableSize * sizeof (Slot) + (uint64_t) header.numPresets * header.rowSize;
+            if (sizeInBytes < expectedSize)
+                return;
+
+            data = static_cast<const uint8_t*> (dataToUse);
+            numParameters = (int) header.numParameters;
+            numPresets = (int) header.numPresets;
+            tableMask = header.tableSize - 1;
+            rowSize = header.rowSize;
+            encoding = header.encoding;
+            values = data + sizeof (Header) + header.tableSize * sizeof (Slot);
+        }
+
+        // False when the data isn't a complete snapshot
+        [[nodiscard]] bool isValid() const noexcept { return data != nullptr; }
+
+        [[nodiscard]] int getNumParameters() const noexcept { return numParameters; }
+        [[nodiscard]] int getNumPresets() const noexcept { return numPresets; }
+        [[nodiscard]] Encoding getEncoding() const noexcept { return encoding; }
+
+        // The column of a parameter, or -1 when the snapshot doesn't have it
+        // The table comes from the file, so a column outside the bank (or a table with no empty slot) is a miss, not a crash
+        [[nodiscard]] int indexOf (std::string_view parameterID) const noexcept
+        {
+            if (! isValid())
+                return -1;
+
+            const auto hash = snapshot::hashID (parameterID);
+            auto slotIndex = (uint32_t) hash & tableMask;
+            for (uint32_t probe = 0; probe <= tableMask; ++probe, slotIndex = (slotIndex + 1) & tableMask)
+            {
+                snapshot::Slot slot;
+                std::memcpy (&slot, data + sizeof (snapshot::Header) + slotIndex * sizeof (snapshot::Slot), sizeof (slot));
+                if (slot.column == snapshot::emptySlot)
+                    return -1;
+                if (slot.hash == hash)
+                    return slot.column < (uint32_t) numParameters ? (int) slot.column : -1;
+            }
+            return -1;
+        }
+
+        // juce::String, std::string, or a literal
+        template <typename StringType>
+        [[nodiscard]] int indexOf (const StringType& parameterID) const noexcept
+        {
+            if constexpr (std::is_same_v<StringType, juce::String>)
+                return indexOf (parsers::toStringView (parameterID));
+            else
+                return indexOf (std::string_view (parameterID));
+        }
+
+        [[nodiscard]] float getNormalized (int preset, int parameter) const noexcept
+        {
+            jassert (juce::isPositiveAndBelow (preset, numPresets) && juce::isPositiveAndBelow (parameter, numParameters));
+            float normalized;
+            getNormalized (preset, parameter, 1, &normalized);
+            return normalized;
+        }
+
+        // A run of numValues parameters of one preset, starting at firstParameter
+        void getNormalized (int preset, int firstParameter, int numValues, float* normalized) const noexcept
+        {
+            jassert (juce::isPositiveAndBelow (preset, numPresets) && firstParameter >= 0 && firstParameter + numValues <= numParameters);
+            const auto* row = values + (size_t) preset * rowSize;
+
+            if (encoding == Encoding::float32)
+            {
+                std::memcpy (normalized, row + (size_t) firstParameter * sizeof (float), (size_t) numValues * sizeof (float));
+                return;
+            }
+
+            const auto* quantized = row + (size_t) firstParameter * sizeof (uint16_t);
+            for (int i = 0; i < numValues; ++i)
+            {
+                uint16_t value;
+                std::memcpy (&value, quantized + (size_t) i * sizeof (uint16_t), sizeof (value));
+                normalized[i] = (float) value * (1.0f / 65535.0f);
+            }
+        }
+
+        // A run of parameters of one preset that share a range (like 20 bands of an EQ), as plain values
+        template <typename RangeType>
+        void getValues (int preset, int firstParameter, int numValues, const RangeType& range, float* unnormalized) const noexcept
+        {
+            getNormalized (preset, firstParameter, numValues, unnormalized);
+            melatonin::convertFrom0to1 (range, unnormalized, unnormalized, numValues);
+        }
+
+        // One parameter across every preset in the bank, for sorting or filtering a browser
+        void getNormalizedForAllPresets (int parameter, float* normalized) const noexcept
+        {
+            jassert (juce::isPositiveAndBelow (parameter, numParameters));
+            const auto* column = values + (size_t) parameter * (encoding == Encoding::float32 ? sizeof (float) : sizeof (uint16_t));
+
+            if (encoding == Encoding::float32)
+            {
+                for (int preset = 0; preset < numPresets; ++preset)
+                    std::memcpy (normalized + preset, column + (size_t) preset * rowSize, sizeof (float));
+                return;
+            }
+
+            for (int preset = 0; preset < numPresets; ++preset)
+            {
+                uint16_t value;
+                std::memcpy (&value, column + (size_t) preset * rowSize, sizeof (value));
+                normalized[preset] = (float) value * (1.0f / 65535.0f);
+            }
+        }
+
+        template <typename RangeType>
+        void getValuesForAllPresets (int parameter, const RangeType& range, float* unnormalized) const noexcept
+        {
+            getNormalizedForAllPresets (parameter, unnormalized);
+            melatonin::convertFrom0to1 (range, unnormalized, unnormalized, numPresets);
+        }
+
+    private:
+        const uint8_t* data = nullptr;
+        const uint8_t* values = nullptr;
+        int numParameters = 0, numPresets = 0;
+        uint32_t tableMask = 0, rowSize = 0;
+        Encoding encoding = Encoding::float32;
+    };
+
+    // A snapshot file, mapped into memory rather than read
+    // Keep it around for as long as the browser is open, the OS pages in only the presets that get previewed
+    class MappedSnapshot : public SnapshotView
+    {
+    public:
+        explicit MappedSnapshot (const juce::File& file)
+            : mappedFile (std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly))
+        {
+            static_cast<SnapshotView&> (*this) = SnapshotView (mappedFile->getData(), mappedFile->getSize());
+        }
+
+    private:
+        std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    };
+
+    // Builds a snapshot, one preset at a time
+    class SnapshotWriter
+    {
+    public:
+        using Encoding = snapshot::Encoding;
+
+        // Every preset has a normalized value for each of these IDs, in this order
+        // Empty when an ID is there twice, or two IDs hash the same, since the bank couldn't tell them apart
+        [[nodiscard]] static std::optional<SnapshotWriter> create (const std::vector<std::string_view>& parameterIDs, Encoding encoding = Encoding::float32)
+        {
+            if (parameterIDs.size() > snapshot::maxParameters)
+                return std::nullopt;
+
+            SnapshotWriter writer (parameterIDs.size(), encoding);
+            auto& table = writer.table;
+            const auto mask = (uint32_t) table.size() - 1;
+            for (size_t column = 0; column < parameterIDs.size(); ++column)
+            {
+                const auto hash = snapshot::hashID (parameterIDs[column]);
+                auto slotIndex = (uint32_t) hash & mask;
+                while (table[slotIndex].column != snapshot::emptySlot)
+                {
+                    if (table[slotIndex].hash == hash)
+                        return std::nullopt;
+                    slotIndex = (slotIndex + 1) & mask;
+                }
+
+                table[slotIndex] = { hash, (uint32_t) column, 0 };
+            }
+            return writer;
+        }
+
+        // getNumParameters() normalized values, in the order of the IDs
+        void addPreset (const float* normalized)
+        {
+            const auto rowSize = snapshot::rowSizeFor (numParameters, encoding);
+            const auto rowStart = values.size();
+            values.resize (rowStart + rowSize, 0);
+            auto* row = values.data() + rowStart;
+
+            if (encoding == Encoding::float32)
+            {
+                for (size_t i = 0; i < numParameters; ++i)
+                {
+                    const auto value = std::clamp (normalized[i], 0.0f, 1.0f);
+                    std::memcpy (row + i * sizeof (float), &value, sizeof (float));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < numParameters; ++i)
+                {
+                    const auto value = (uint16_t) juce::roundToInt (std::clamp (normalized[i], 0.0f, 1.0f) * 65535.0f);
+                    std::memcpy (row + i * sizeof (uint16_t), &value, sizeof (uint16_t));
+                }
+            }
+
+            ++numPresets;
+        }
+
+        [[nodiscard]] int getNumParameters() const noexcept { return (int) numParameters; }
+        [[nodiscard]] int getNumPresets() const noexcept { return (int) numPresets; }
+
+        [[nodiscard]] juce::MemoryBlock toMemoryBlock() const
+        {
+            const snapshot::Header header { snapshot::magic, snapshot::version, encoding, (uint32_t) numParameters, (uint32_t) numPresets, (uint32_t) table.size(), snapshot::rowSizeFor (numParameters, encoding), 0 };
+
+            juce::MemoryBlock block;
+            block.append (&header, sizeof (header));
+            block.append (table.data(), table.size() * sizeof (snapshot::Slot));
+            block.append (values.data(), values.size());
+            return block;
+        }
+
+        bool writeTo (const juce::File& file) const
+        {
+            const auto block = toMemoryBlock();
+            return file.replaceWithData (block.getData(), block.getSize());
+        }
+
+    private:
+        SnapshotWriter (size_t numParametersToUse, Encoding encodingToUse)
+            : numParameters (numParametersToUse), encoding (encodingToUse),
+              table (snapshot::tableSizeFor (numParametersToUse), snapshot::Slot { 0, snapshot::emptySlot, 0 })
+        {
+        }
+
+        size_t numParameters;
+        size_t numPresets = 0;
+        Encoding encoding;
+        std::vector<snapshot::Slot> table;
+        std::vector<uint8_t> values;
+    };
+}
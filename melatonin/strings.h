@@ -1,156 +1,83 @@
 #pragma once
 
+// The stringFrom* lambdas format through melatonin/formatters.h, so they only allocate the returned juce::String.
+// Use melatonin::format directly to skip even that.
+// They take a float or a double, a double is formatted at double precision.
+// The *FromString lambdas parse through melatonin/parsers.h, which works on any std::string_view without allocating.
+
 // maximumStringLength is unused in this function
 // but must stay in place as it's the required signature for juce::AudioParameterFloat
-static inline auto stringFromTimeValue = [] (float value, [[maybe_unused]] int maximumStringLength = 5) {
-    juce::String result;
-
-    if ((value < 0.0) || (value == 0.0))
-    {
-        result = juce::String ("0ms");
-    }
-    else if (value < 0.5)
-    {
-        // We want 0 number of decimal places for ms values
-        auto rawResult = juce::String (value * 1000, 1).dropLastCharacters (2);
-        result = rawResult + "ms";
-    }
-    else
-    {
-        auto rawResult = juce::String (value, 2);
-        result = rawResult + "s";
-    }
-
-    return result;
+static inline auto stringFromTimeValue = [] (auto value, [[maybe_unused]] int maximumStringLength = 5) {
+    return melatonin::formatToString<melatonin::formatters::Time> (value);
 };
 
 // The value can either be 0ms, 11.1ms, 100ms, 1.0s, 15.98s
 // The values can also come in without labels
 // In that case, single digits or a decimal place will trigger seconds conversion
 static inline auto timeValueFromString = [] (const juce::String& text) {
-    float value;
-    if (text.endsWith ("ms"))
-    {
-        value = text.dropLastCharacters (2).getFloatValue() / 1000.0f;
-    }
-    else if (text.endsWith ("s"))
-    {
-        value = text.dropLastCharacters (1).getFloatValue();
-    }
-    else if (text.contains ("."))
-    {
-        value = text.getFloatValue();
-    }
-    else
-    {
-        value = text.getFloatValue() / 1000.0f;
-    }
-    return value;
-};
-
-static inline auto stringFromDBValue = [] (float value, [[maybe_unused]] int maximumStringLength = 5) {
+    return melatonin::parsers::timeValue (melatonin::parsers::toStringView (text));
+};
+
+static inline auto stringFromDBValue = [] (auto value, [[maybe_unused]] int maximumStringLength = 5) {
     // only 1 decimal place for db values
-    return juce::String (value, 1) + "db";
+    return melatonin::formatToString<melatonin::formatters::Decibels> (value);
 };
 
 static inline auto dBFromString = [] (const juce::String& text) {
-    if (text.endsWith ("db"))
-    {
-        return text.dropLastCharacters (2).getFloatValue();
-    }
-    else
-        return text.getFloatValue();
+    return melatonin::parsers::dB (melatonin::parsers::toStringView (text));
 };
 
-// make this accept float or double
-static inline auto stringFromDBValueWithOffAt64 = [] (float value, [[maybe_unused]] int maximumStringLength = 5) {
+static inline auto stringFromDBValueWithOffAt64 = [] (auto value, [[maybe_unused]] int maximumStringLength = 5) {
     // only 1 decimal place for db values
-    if (juce::approximatelyEqual (value, -64.0f))
-        return juce::String ("OFF");
-    return juce::String (value, 1) + "db";
+    return melatonin::formatToString<melatonin::formatters::DecibelsWithOffAt64> (value);
 };
 
 static inline auto dBFromStringWithOffAt64 = [] (const juce::String& text) {
-    if (text.toLowerCase() == "off")
-        return -64.0f;
-    if (text.endsWith ("db"))
-    {
-        return text.dropLastCharacters (2).getFloatValue();
-    }
-    else
-        return text.getFloatValue();
+    return melatonin::parsers::dBWithOffAt64 (melatonin::parsers::toStringView (text));
 };
 
-static inline auto stringFromIntValue = [] (float value, [[maybe_unused]] int maximumStringLength = 5) {
-    return juce::String ((int) value);
+static inline auto stringFromIntValue = [] (auto value, [[maybe_unused]] int maximumStringLength = 5) {
+    return melatonin::formatToString<melatonin::formatters::Int> (value);
 };
 
 static inline auto intValueFromString = [] (const juce::String& text) {
-    return (float) text.getIntValue();
+    return melatonin::parsers::intValue (melatonin::parsers::toStringView (text));
 };
 
-static inline auto stringFromPercentValue = [] (float value, [[maybe_unused]] int maximumStringLength = 0) {
-    // we want 0 significant digits, but this juce string helper is odd...
-    // so we have to make one decimal place, then drop that and the decimal char
-    return juce::String (value * 100.0f, 1).dropLastCharacters (2) + "%";
+static inline auto stringFromPercentValue = [] (auto value, [[maybe_unused]] int maximumStringLength = 0) {
+    // we want 0 significant digits, rounded the way juce::String (value, 1) rounds
+    return melatonin::formatToString<melatonin::formatters::Percent> (value);
 };
 
 template <int MaxDigits>
-static inline auto stringFromPercentValueWithDigits = [] (float value, [[maybe_unused]] int maximumStringLength = 0) {
-    if (juce::approximatelyEqual (value, 0.0f))
-        return juce::String ("OFF");
-
-    return juce::String (value * 100.0f, MaxDigits) + "%";
+static inline auto stringFromPercentValueWithDigits = [] (auto value, [[maybe_unused]] int maximumStringLength = 0) {
+    return melatonin::formatToString<melatonin::formatters::PercentWithDigits<MaxDigits>> (value);
 };
 
 static inline auto percentValueFromString = [] (const juce::String& text) {
-    if (text.toLowerCase() == "off")
-    {
-        return 0.0f;
-    }
-    else if (text.endsWith ("%"))
-    {
-        return text.dropLastCharacters (1).getFloatValue() / 100.0f;
-    }
-    return text.getFloatValue() / 100.0f;
+    return melatonin::parsers::percentValue (melatonin::parsers::toStringView (text));
 };
 
-static inline auto stringFromHzValue = [] (float value, [[maybe_unused]] int maximumStringLength = 5) {
-    if (value >= 1500.f)
-        return juce::String(value / 1000.0f, 1) + " kHz";
-    if (value < 2.0f)
-        return juce::String (value, 2) + " Hz";
-    if (value < 10.0f)
-        return juce::String (value, 1) + " Hz";
-
-    return juce::String (value, 1).dropLastCharacters (2) + " Hz";
+static inline auto stringFromHzValue = [] (auto value, [[maybe_unused]] int maximumStringLength = 5) {
+    return melatonin::formatToString<melatonin::formatters::Hz> (value);
 };
 
 static inline auto hzValueFromString = [] (const juce::String& text) {
-
-    if (text.toLowerCase().endsWith("khz"))
-    {
-        return text.dropLastCharacters (3).getFloatValue() * 1000.0f;
-    }
-    if (text.toLowerCase().endsWith ("hz"))
-    {
-        return text.dropLastCharacters (2).getFloatValue();
-    }
-    return text.getFloatValue();
+    return melatonin::parsers::hzValue (melatonin::parsers::toStringView (text));
 };
 
-static inline auto stringFromSemiValue = [] (float value, [[maybe_unused]] int maximumStringLength = 5) {
-    return juce::String ((int) value) + " semi";
+static inline auto stringFromSemiValue = [] (auto value, [[maybe_unused]] int maximumStringLength = 5) {
+    return melatonin::formatToString<melatonin::formatters::Semi> (value);
 };
 
 static inline auto semiValueFromString = [] (const juce::String& text) {
-    return (float) text.getIntValue();
+    return melatonin::parsers::semiValue (melatonin::parsers::toStringView (text));
 };
 
-static inline auto stringFrom0to1 = [] (float value, [[maybe_unused]] int maximumStringLength = 4) {
-    return juce::String (value, maximumStringLength);
+static inline auto stringFrom0to1 = [] (auto value, [[maybe_unused]] int maximumStringLength = 4) {
+    return melatonin::formatToString<melatonin::formatters::ZeroTo1> (value, maximumStringLength);
 };
 
 static inline auto zeroTo1FromString = [] (const juce::String& text) {
-    return text.getFloatValue();
+    return melatonin::parsers::zeroTo1 (melatonin::parsers::toStringView (text));
 };
@@ -0,0 +1,169 @@
+#pragma once
+
+// Remembers the text of the last few displayed values of a parameter
+//
+// Most calls to a stringFrom* helper format something that was already formatted:
+// stringFromDBValue only shows one decimal, so thousands of floats end up as the same "-6.1db".
+// The cache is keyed on what's displayed (Formatter::quantize, see formatters.h), not on the float,
+// so every one of those values is a hit and only the first one gets rendered.
+//
+// One cache per parameter, usable from any thread. Reads never lock or allocate, each slot is a seqlock.
+// When two threads happen to write the same slot at once, one of them just skips caching its text.
+//
+//    juce::AudioParameterFloat ("gain", "Gain", decibelRange (-30.0f, 0.0f), 0.0f, juce::String(),
+//        juce::AudioProcessorParameter::genericParameter, melatonin::cachedStringFrom<melatonin::formatters::Decibels>(), dBFromString)
+//
+// Components can skip repainting when the text wouldn't change, without formatting anything:
+//
+//    if (melatonin::TextCache<melatonin::formatters::Decibels>::hasChanged (gain->get(), lastDisplayed))
+//        repaint();
+namespace melatonin
+{
+    template <typename Formatter, size_t NumSlots = 16, size_t MaxLength = 23>
+    class TextCache
+    {
+    public:
+        static_assert (NumSlots > 0 && (NumSlots & (NumSlots - 1)) == 0, "NumSlots must be a power of 2");
+        static_assert (MaxLength < 256, "Lengths are stored in a byte");
+
+        // Same as melatonin::format, but from the cache when possible
+        template <typename ValueType>
+        size_t format (ValueType value, char* destination, size_t size, int maximumStringLength = Formatter::defaultMaximumStringLength) noexcept
+        {
+            const auto key = Formatter::quantize ((FormatFloatType<ValueType>) value, maximumStringLength);
+            auto& slot = slots[slotIndex (key)];
+
+            Entry entry;
+            if (slot.read (entry) && entry.key == key)
+            {
+                TextWriter text (destination, size);
+                text.append (entry.text, entry.length);
+                return text.getLength();
+            }
+
+            TextWriter text (destination, size);
+            Formatter::render (key, text);
+
+            // a truncated render isn't the full text, so it can't be cached
+            if (text.getLength() <= MaxLength && text.getLength() < size - 1)
+            {
+                entry.key = key;
+                entry.length = (uint8_t) text.getLength();
+                std::memcpy (entry.text, destination, entry.length);
+                slot.write (entry);
+            }
+
+            return text.getLength();
+        }
+
+        template <typename ValueType, size_t Size>
+        std::string_view format (ValueType value, std::array<char, Size>& destination, int maximumStringLength = Formatter::defaultMaximumStringLength) noexcept
+        {
+            return { destination.data(), format (value, destination.data(), Size, maximumStringLength) };
+        }
+
+        // For juce::AudioParameterFloat, only allocates the returned juce::String
+        template <typename ValueType>
+        juce::String toString (ValueType value, int maximumStringLength = Formatter::defaultMaximumStringLength)
+        {
+            std::array<char, 64> text;
+            const auto length = format (value, text.data(), text.size(), maximumStringLength);
+            return { text.data(), length };
+        }
+
+        // True when value would display differently than lastDisplayed, which is then updated
+        // Only quantizes, so it's cheap enough to call from a timer for every label
+        template <typename ValueType>
+        static bool hasChanged (ValueType value, DisplayValue& lastDisplayed, int maximumStringLength = Formatter::defaultMaximumStringLength) noexcept
+        {
+            const auto key = Formatter::quantize ((FormatFloatType<ValueType>) value, maximumStringLength);
+            if (key == lastDisplayed)
+                return false;
+
+            lastDisplayed = key;
+            return true;
+        }
+
+    private:
+        struct Entry
+        {
+            DisplayValue key;
+            uint8_t length = 0;
+            char text[MaxLength] {};
+        };
+
+        class Slot
+        {
+        public:
+            bool read (Entry& entry) const noexcept
+            {
+                // a writer is rarely in the way, so give it a couple of tries before calling it a miss
+                for (int attempt = 0; attempt < 2; ++attempt)
+                {
+                    const auto before = sequence.load (std::memory_order_acquire);
+                    if (before == 0)
+                        return false; // never written
+                    if (before & 1)
+                        continue;
+
+                    std::array<uint64_t, numWords> copy;
+                    for (size_t i = 0; i < numWords; ++i)
+                        copy[i] = words[i].load (std::memory_order_relaxed);
+
+                    std::atomic_thread_fence (std::memory_order_acquire);
+                    if (sequence.load (std::memory_order_relaxed) == before)
+                    {
+                        std::memcpy (static_cast<void*> (&entry), copy.data(), sizeof (Entry));
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void write (const Entry& entry) noexcept
+            {
+                auto before = sequence.load (std::memory_order_relaxed);
+                if ((before & 1) || ! sequence.compare_exchange_strong (before, before + 1, std::memory_order_acquire))
+                    return; // someone else is writing this slot, let them have it
+
+                std::atomic_thread_fence (std::memory_order_release);
+
+                std::array<uint64_t, numWords> copy {};
+                std::memcpy (copy.data(), &entry, sizeof (Entry));
+                for (size_t i = 0; i < numWords; ++i)
+                    words[i].store (copy[i], std::memory_order_relaxed);
+
+                sequence.store (before + 2, std::memory_order_release);
+            }
+
+        private:
+            static constexpr size_t numWords = (sizeof (Entry) + sizeof (uint64_t) - 1) / sizeof (uint64_t);
+
+            // odd while being written, 0 until the first write
+            std::atomic<uint32_t> sequence { 0 };
+            std::array<std::atomic<uint64_t>, numWords> words {};
+        };
+
+        std::array<Slot, NumSlots> slots;
+
+        static size_t slotIndex (const DisplayValue& key) noexcept
+        {
+            uint64_t valueBits;
+            std::memcpy (&valueBits, &key.number.value, sizeof (valueBits));
+
+            auto hash = key.number.fallback ? valueBits : (uint64_t) key.number.scaled;
+            hash ^= ((uint64_t) key.branch << 56) ^ ((uint64_t) key.number.negative << 48) ^ ((uint64_t) (uint8_t) key.number.decimals << 40);
+            hash *= 0x9e3779b97f4a7c15ull;
+            return (size_t) (hash >> 32) & (NumSlots - 1);
+        }
+    };
+
+    // A drop in replacement for the stringFrom* lambda matching Formatter, with its own cache
+    template <typename Formatter>
+    static inline auto cachedStringFrom()
+    {
+        return [cache = std::make_shared<TextCache<Formatter>>()] (auto value, int maximumStringLength = Formatter::defaultMaximumStringLength) {
+            return cache->toString (value, maximumStringLength);
+        };
+    }
+}
@@ -1,10 +1,38 @@
-#if RUN_MELATONIN_TESTS
+#if RUN_MELATONIN_TESTS || RUN_MELATONIN_BENCHMARKS
 
     #include "melatonin_parameters.h"
     #include <catch2/catch_approx.hpp>
+    #include <catch2/catch_message.hpp>
+    #include <catch2/catch_template_test_macros.hpp>
     #include <catch2/catch_test_macros.hpp>
     #include <juce_core/juce_core.h>
+    #include "tests/allocation_counter.cpp"
+
+    // each test file ends with its benchmarks, which only compile with this flag
+    #if RUN_MELATONIN_BENCHMARKS
+        #include <catch2/benchmark/catch_benchmark.hpp>
+        #include "tests/benchmarks.cpp"
+    #endif
+
+    #include "tests/fast_math.cpp"
     #include "tests/ranges.cpp"
+    #include "tests/range_types.cpp"
+    #include "tests/piecewise_range.cpp"
+    #include "tests/compact_range.cpp"
+    #include "tests/range_registry.cpp"
+    #include "tests/snapping.cpp"
+    #include "tests/harmonic_bank.cpp"
+    #include "tests/lookup_table.cpp"
+    #include "tests/smoothing.cpp"
+    #include "tests/automation.cpp"
     #include "tests/strings.cpp"
+    #include "tests/formatters.cpp"
+    #include "tests/parsers.cpp"
+    #include "tests/text_cache.cpp"
+    #include "tests/label_table.cpp"
+    #include "tests/bulk.cpp"
+    #include "tests/snapshot.cpp"
+    #include "tests/morph.cpp"
+    #include "tests/parameter_store.cpp"
 
 #endif
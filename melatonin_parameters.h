@@ -15,5 +15,25 @@ END_JUCE_MODULE_DECLARATION
 #pragma once
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_core/juce_core.h>
+#include "melatonin/simd.h"
+#include "melatonin/fast_math.h"
+#include "melatonin/snapping.h"
 #include "melatonin/ranges.h"
+#include "melatonin/range_types.h"
+#include "melatonin/piecewise_range.h"
+#include "melatonin/compact_range.h"
+#include "melatonin/range_registry.h"
+#include "melatonin/blocks.h"
+#include "melatonin/harmonic_bank.h"
+#include "melatonin/lookup_table.h"
+#include "melatonin/smoothing.h"
+#include "melatonin/automation.h"
+#include "melatonin/formatters.h"
+#include "melatonin/parsers.h"
+#include "melatonin/text_cache.h"
 #include "melatonin/strings.h"
+#include "melatonin/label_table.h"
+#include "melatonin/bulk.h"
+#include "melatonin/snapshot.h"
+#include "melatonin/morph.h"
+#include "melatonin/parameter_store.h"
@@ -0,0 +1,79 @@
+// Counts allocations by replacing the global operator new, so tests and benchmarks can check what allocates
+//
+// This is why neither RUN_MELATONIN_TESTS nor RUN_MELATONIN_BENCHMARKS should be set on anything but a test binary.
+namespace melatonin::allocations
+{
+    // per thread, so allocations on other threads (like JUCE's message thread) don't get counted
+    static thread_local size_t count = 0;
+    static thread_local size_t bytes = 0;
+
+    template <typename Function>
+    static double perCall (Function&& function)
+    {
+        constexpr int numCalls = 100;
+        const auto before = count;
+        for (int i = 0; i < numCalls; ++i)
+            [[maybe_unused]] auto result = function (i);
+        return (double) (count - before) / numCalls;
+    }
+
+    // What an object costs: its own size plus whatever it allocated while being made
+    template <typename Function>
+    static size_t bytesPerObject (Function&& makeObject)
+    {
+        const auto before = bytes;
+        [[maybe_unused]] auto object = makeObject();
+        return sizeof (object) + bytes - before;
+    }
+
+    // Every replacement below allocates and frees through this pair, so each new has a matching delete,
+    // aligned allocations included (they keep the pointer malloc returned just in front of the one they hand out).
+    // Freeing stays out of line, otherwise the compiler inlines each delete into its caller and warns about free being called
+    // on memory that came from new (-Wmismatched-new-delete), even though it's the same malloc underneath.
+    static void* allocate (std::size_t size, std::size_t alignment, bool throwOnFailure)
+    {
+        ++count;
+        bytes += size;
+
+        const auto padding = alignment + sizeof (void*);
+        if (auto block = std::malloc ((size == 0 ? 1 : size) + padding))
+        {
+            const auto aligned = (reinterpret_cast<uintptr_t> (block) + padding) & ~(uintptr_t) (alignment - 1);
+            auto pointer = reinterpret_cast<void*> (aligned);
+            static_cast<void**> (pointer)[-1] = block;
+            return pointer;
+        }
+
+        if (throwOnFailure)
+            throw std::bad_alloc();
+        return nullptr;
+    }
+
+    [[gnu::noinline]] static void deallocate (void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            std::free (static_cast<void**> (pointer)[-1]);
+    }
+}
+
+void* operator new (std::size_t size) { return melatonin::allocations::allocate (size, alignof (std::max_align_t), true); }
+void* operator new[] (std::size_t size) { return melatonin::allocations::allocate (size, alignof (std::max_align_t), true); }
+void* operator new (std::size_t size, std::align_val_t alignment) { return melatonin::allocations::allocate (size, (std::size_t) alignment, true); }
+void* operator new[] (std::size_t size, std::align_val_t alignment) { return melatonin::allocations::allocate (size, (std::size_t) alignment, true); }
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept { return melatonin::allocations::allocate (size, alignof (std::max_align_t), false); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept { return melatonin::allocations::allocate (size, alignof (std::max_align_t), false); }
+void* operator new (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return melatonin::allocations::allocate (size, (std::size_t) alignment, false); }
+void* operator new[] (std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return melatonin::allocations::allocate (size, (std::size_t) alignment, false); }
+
+void operator delete (void* pointer) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete[] (void* pointer) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete (void* pointer, std::size_t) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete[] (void* pointer, std::size_t) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete (void* pointer, std::align_val_t) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete[] (void* pointer, std::align_val_t) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete (void* pointer, std::size_t, std::align_val_t) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete[] (void* pointer, std::size_t, std::align_val_t) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete (void* pointer, const std::nothrow_t&) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete[] (void* pointer, const std::nothrow_t&) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete (void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { melatonin::allocations::deallocate (pointer); }
+void operator delete[] (void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { melatonin::allocations::deallocate (pointer); }
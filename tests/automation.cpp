@@ -0,0 +1,114 @@
+TEST_CASE ("Melatonin Parameters automation renderer")
+{
+    const auto range = melatonin::LogRange (20.0f, 20000.0f, 10.0f);
+    std::vector<float> block (16);
+
+    auto normalizedBlock = [&] (const auto& renderer) {
+        std::vector<float> normalized;
+        for (auto value : block)
+            normalized.push_back (renderer.getRange().convertTo0to1 (value));
+        return normalized;
+    };
+
+    SECTION ("without points it holds the last value")
+    {
+        melatonin::AutomationRenderer<melatonin::LogRange> renderer { range, 0.5f };
+        renderer.render (nullptr, 0, block.data(), (int) block.size());
+        for (auto value : block)
+            CHECK (value == Catch::Approx (range.convertFrom0to1 (0.5f)));
+    }
+
+    SECTION ("interpolates in the normalized domain and lands on each point")
+    {
+        melatonin::AutomationRenderer<melatonin::LogRange> renderer { range, 0.0f };
+        const std::array<melatonin::AutomationPoint, 2> points { { { 3, 1.0f }, { 11, 0.5f } } };
+        renderer.render (points, block.data(), (int) block.size());
+
+        const auto normalized = normalizedBlock (renderer);
+        CHECK (normalized[0] == Catch::Approx (0.25f).margin (1e-5));
+        CHECK (normalized[1] == Catch::Approx (0.5f).margin (1e-5));
+        CHECK (normalized[2] == Catch::Approx (0.75f).margin (1e-5));
+        CHECK (normalized[3] == Catch::Approx (1.0f).margin (1e-5));
+        CHECK (normalized[7] == Catch::Approx (0.75f).margin (1e-5));
+        CHECK (normalized[11] == Catch::Approx (0.5f).margin (1e-5));
+        CHECK (normalized[15] == Catch::Approx (0.5f).margin (1e-5));
+
+        // a sweep up the range is a curve in Hz
+        CHECK (block[1] == Catch::Approx (range.convertFrom0to1 (0.5f)));
+        CHECK (block[1] < 1000.0f);
+
+        CHECK (renderer.getCurrentNormalized() == 0.5f);
+    }
+
+    SECTION ("the next block continues from the last point")
+    {
+        melatonin::AutomationRenderer<melatonin::LogRange> renderer { range, 0.0f };
+        const std::vector<melatonin::AutomationPoint> first { { 15, 0.5f } }, second { { 3, 1.0f } };
+        renderer.render (first, block.data(), (int) block.size());
+        CHECK (normalizedBlock (renderer)[7] == Catch::Approx (0.25f).margin (1e-5));
+
+        renderer.render (second, block.data(), (int) block.size());
+        const auto normalized = normalizedBlock (renderer);
+        CHECK (normalized[0] == Catch::Approx (0.625f).margin (1e-5));
+        CHECK (normalized[3] == Catch::Approx (1.0f).margin (1e-5));
+    }
+
+    SECTION ("a point at offset 0 or several at one offset jump")
+    {
+        melatonin::AutomationRenderer<melatonin::LinearRange> renderer { melatonin::LinearRange (0.0f, 10.0f), 0.0f };
+        const std::vector<melatonin::AutomationPoint> points { { 0, 0.8f }, { 4, 0.4f }, { 4, 0.2f } };
+        renderer.render (points, block.data(), (int) block.size());
+        CHECK (block[0] == Catch::Approx (8.0f));
+        CHECK (block[2] == Catch::Approx (6.0f));
+        CHECK (block[4] == Catch::Approx (2.0f));
+        CHECK (block[15] == Catch::Approx (2.0f));
+    }
+
+    SECTION ("matches a juce::NormalisableRange factory")
+    {
+        melatonin::AutomationRenderer<melatonin::LogRange> typed { range, 0.1f };
+        melatonin::AutomationRenderer<juce::NormalisableRange<float>> factory { logarithmicRange (20.0f, 20000.0f, 10.0f), 0.1f };
+        const std::vector<melatonin::AutomationPoint> points { { 5, 0.9f }, { 9, 0.3f } };
+
+        std::vector<float> factoryBlock (block.size());
+        typed.render (points, block.data(), (int) block.size());
+        factory.render (points, factoryBlock.data(), (int) factoryBlock.size());
+        for (size_t i = 0; i < block.size(); ++i)
+            CHECK (block[i] == Catch::Approx (factoryBlock[i]).epsilon (1e-5));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters automation renderer benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("rendering automation for a block of 512")
+    {
+        // dense automation, a point every 16 samples
+        std::vector<melatonin::AutomationPoint> points;
+        for (int i = 0; i < 32; ++i)
+            points.push_back ({ i * 16 + 15, normalized[(size_t) i] });
+
+        std::vector<float> results (512);
+        melatonin::AutomationRenderer<juce::NormalisableRange<float>> factory { logarithmicRange (20.0f, 20000.0f, 10.0f) };
+        BENCHMARK ("AutomationRenderer<NormalisableRange>")
+        {
+            factory.render (points, results.data(), (int) results.size());
+            return results[0];
+        };
+
+        for (auto [name, accuracy] : { std::pair ("exact", melatonin::Accuracy::exact), std::pair ("fast", melatonin::Accuracy::fast) })
+        {
+            melatonin::AutomationRenderer<melatonin::LogRange> typed { melatonin::LogRange (20.0f, 20000.0f, 10.0f, accuracy) };
+            BENCHMARK (std::string ("AutomationRenderer<LogRange> ") + name)
+            {
+                typed.render (points, results.data(), (int) results.size());
+                return results[0];
+            };
+
+            CHECK (melatonin::allocations::perCall ([&] (int) { typed.render (points, results.data(), (int) results.size()); return results[0]; }) == 0);
+        }
+    }
+}
+#endif
@@ -0,0 +1,39 @@
+// What the benchmarks share. Each feature's benchmarks sit next to its tests, in a "[!benchmark]" test case
+//
+// Catch2 reports the time per call, and allocations per call are checked or reported as a warning (see allocation_counter.cpp),
+// so there's a baseline to compare the faster paths (and future module updates) against.
+namespace melatonin::benchmarks
+{
+    // 1024 values spread over 0-1, so every call sees a different value without the cost of a random number generator
+    static std::vector<float> normalizedValues()
+    {
+        std::vector<float> values;
+        for (size_t i = 0; i < 1024; ++i)
+            values.push_back ((float) ((i * 617) % 1024) / 1023.0f);
+        return values;
+    }
+
+    // Both directions of a range, one value at a time through its std::functions
+    static void benchmarkRange (const std::string& name, const juce::NormalisableRange<float>& range)
+    {
+        const auto normalized = normalizedValues();
+        std::vector<float> unnormalized;
+        for (auto value : normalized)
+            unnormalized.push_back (range.convertFrom0to1 (value));
+
+        size_t i = 0;
+        BENCHMARK (name + " convertFrom0to1")
+        {
+            return range.convertFrom0to1 (normalized[i++ & 1023]);
+        };
+
+        BENCHMARK (name + " convertTo0to1")
+        {
+            return range.convertTo0to1 (unnormalized[i++ & 1023]);
+        };
+
+        // std::function shouldn't allocate on the way through
+        CHECK (melatonin::allocations::perCall ([&] (int n) { return range.convertFrom0to1 (normalized[(size_t) n]); }) == 0);
+        CHECK (melatonin::allocations::perCall ([&] (int n) { return range.convertTo0to1 (unnormalized[(size_t) n]); }) == 0);
+    }
+}
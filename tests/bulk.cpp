@@ -0,0 +1,131 @@
+TEST_CASE ("Melatonin Parameters bulk")
+{
+    // an odd number, so the last chunk is partial and the last few values aren't a whole SIMD group
+    const int numValues = 50003;
+    std::vector<float> normalized ((size_t) numValues);
+    for (size_t i = 0; i < normalized.size(); ++i)
+        normalized[i] = (float) ((i * 7919) % 10007) / 10006.0f;
+
+    juce::ThreadPool pool (4);
+
+    SECTION ("chunks cover every item exactly once")
+    {
+        for (auto chunkSize : { 1, 64, 100, 4096, 100000 })
+        {
+            // Catch's assertions aren't thread safe, so the workers only count
+            std::vector<std::atomic<int>> visits ((size_t) numValues);
+            std::atomic<int> numUnevenStarts { 0 };
+            melatonin::bulk::forEachChunk (
+                numValues, [&] (int start, int end) {
+                    numUnevenStarts += start % 64 != 0;
+                    for (int i = start; i < end; ++i)
+                        visits[(size_t) i]++;
+                },
+                &pool,
+                chunkSize);
+
+            CHECK (numUnevenStarts == 0);
+            for (auto& count : visits)
+                CHECK (count == 1);
+        }
+
+        melatonin::bulk::forEachChunk (0, [] (int, int) { FAIL ("nothing to do"); }, &pool);
+    }
+
+    SECTION ("range conversions are identical to converting serially")
+    {
+        auto checkRange = [&] (const auto& range) {
+            std::vector<float> serial ((size_t) numValues), parallel ((size_t) numValues), backSerial ((size_t) numValues), backParallel ((size_t) numValues);
+            melatonin::convertFrom0to1 (range, normalized.data(), serial.data(), numValues);
+            melatonin::bulk::convertFrom0to1 (range, normalized.data(), parallel.data(), numValues, &pool);
+            CHECK (serial == parallel);
+
+            melatonin::convertTo0to1 (range, serial.data(), backSerial.data(), numValues);
+            melatonin::bulk::convertTo0to1 (range, serial.data(), backParallel.data(), numValues, &pool, 1000);
+            CHECK (backSerial == backParallel);
+        };
+
+        checkRange (melatonin::LogRange (20.0f, 20000.0f, 10.0f, melatonin::Accuracy::fast));
+        checkRange (melatonin::reversed (melatonin::DecibelRange (-60.0f, 6.0f)));
+        checkRange (melatonin::PiecewiseRange<>::logWithLinearStart (0.0f, 10000.0f, 6.0f, 1000));
+        checkRange (melatonin::CompactRange::log (0.0f, 15.0f));
+        checkRange (logarithmicRange (0.0f, 15.0f));
+    }
+
+    SECTION ("formatting and parsing match the lambdas")
+    {
+        const auto range = logarithmicRange (20.0f, 20000.0f, 10.0f);
+        std::vector<float> frequencies ((size_t) numValues);
+        melatonin::bulk::convertFrom0to1 (range, normalized.data(), frequencies.data(), numValues, &pool);
+
+        std::vector<juce::String> labels ((size_t) numValues);
+        melatonin::bulk::format<melatonin::formatters::Hz> (frequencies.data(), labels.data(), numValues, &pool);
+
+        std::vector<std::string_view> texts;
+        for (auto& label : labels)
+            texts.push_back (melatonin::parsers::toStringView (label));
+
+        std::vector<melatonin::parsers::ParseResult<float>> parsed ((size_t) numValues);
+        melatonin::bulk::parse<melatonin::parsers::Hz> (texts.data(), parsed.data(), numValues, &pool);
+
+        for (size_t i = 0; i < frequencies.size(); i += 97)
+        {
+            CHECK (labels[i] == stringFromHzValue (frequencies[i]));
+            CHECK (parsed[i]);
+            CHECK (parsed[i].value == hzValueFromString (labels[i]));
+        }
+
+        // and without a pool
+        std::vector<float> lenient ((size_t) numValues);
+        melatonin::bulk::transform (texts.data(), lenient.data(), numValues, [] (std::string_view text) { return melatonin::parsers::hzValue (text); });
+        for (size_t i = 0; i < lenient.size(); ++i)
+            CHECK (lenient[i] == parsed[i].value);
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters bulk benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("a preset library in bulk")
+    {
+        // 10,000 presets with 20 frequency parameters each
+        std::vector<float> frequencies;
+        for (size_t i = 0; i < 200000; ++i)
+            frequencies.push_back (logarithmicRange (20.0f, 20000.0f, 10.0f).convertFrom0to1 (normalized[i & 1023]));
+
+        std::vector<juce::String> labels (frequencies.size());
+        std::vector<std::string_view> texts;
+        std::vector<melatonin::parsers::ParseResult<float>> parsed (frequencies.size());
+        juce::ThreadPool pool (juce::SystemStats::getNumCpus());
+
+        BENCHMARK ("format 200000 Hz values, serial")
+        {
+            melatonin::bulk::format<melatonin::formatters::Hz> (frequencies.data(), labels.data(), (int) labels.size());
+            return labels[0].length();
+        };
+
+        BENCHMARK ("format 200000 Hz values, thread pool")
+        {
+            melatonin::bulk::format<melatonin::formatters::Hz> (frequencies.data(), labels.data(), (int) labels.size(), &pool);
+            return labels[0].length();
+        };
+
+        for (auto& label : labels)
+            texts.push_back (melatonin::parsers::toStringView (label));
+
+        BENCHMARK ("parse 200000 Hz values, serial")
+        {
+            melatonin::bulk::parse<melatonin::parsers::Hz> (texts.data(), parsed.data(), (int) texts.size());
+            return parsed[0].value;
+        };
+
+        BENCHMARK ("parse 200000 Hz values, thread pool")
+        {
+            melatonin::bulk::parse<melatonin::parsers::Hz> (texts.data(), parsed.data(), (int) texts.size(), &pool);
+            return parsed[0].value;
+        };
+    }
+}
+#endif
@@ -0,0 +1,116 @@
+TEST_CASE ("Melatonin Parameters compact range")
+{
+    STATIC_REQUIRE (sizeof (melatonin::CompactRange) <= 32);
+
+    // each kind should convert exactly like the range type it stands in for (it runs the same curve)
+    auto checkAgainst = [] (const melatonin::CompactRange& compact, const auto& rangeType) {
+        CHECK (compact.getStart() == rangeType.getStart());
+        CHECK (compact.getEnd() == Catch::Approx (rangeType.getEnd()));
+
+        std::vector<float> normalized, unnormalized;
+        for (int i = -10; i <= 110; ++i)
+        {
+            normalized.push_back ((float) i / 100.0f);
+            unnormalized.push_back (rangeType.convertFrom0to1 (normalized.back()));
+            CHECK (compact.convertFrom0to1 (normalized.back()) == unnormalized.back());
+            CHECK (compact.convertTo0to1 (unnormalized.back()) == rangeType.convertTo0to1 (unnormalized.back()));
+        }
+
+        std::vector<float> blockUnnormalized (normalized.size()), blockNormalized (normalized.size());
+        compact.convertFrom0to1 (normalized.data(), blockUnnormalized.data(), (int) normalized.size());
+        compact.convertTo0to1 (unnormalized.data(), blockNormalized.data(), (int) unnormalized.size());
+        for (size_t i = 0; i < normalized.size(); ++i)
+        {
+            CHECK (blockUnnormalized[i] == compact.convertFrom0to1 (normalized[i]));
+            CHECK (blockNormalized[i] == compact.convertTo0to1 (unnormalized[i]));
+        }
+
+        juce::NormalisableRange<float> converted = compact;
+        CHECK (converted.start == compact.getStart());
+        CHECK (converted.convertFrom0to1 (0.3f) == Catch::Approx (rangeType.convertFrom0to1 (0.3f)));
+    };
+
+    SECTION ("every kind")
+    {
+        checkAgainst (melatonin::CompactRange::linear (-1.0f, 1.0f), melatonin::LinearRange (-1.0f, 1.0f));
+        checkAgainst (melatonin::CompactRange::log (0.0f, 15.0f), melatonin::LogRange (0.0f, 15.0f));
+        checkAgainst (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f, melatonin::Accuracy::fast), melatonin::LogRange (20.0f, 20000.0f, 10.0f, melatonin::Accuracy::fast));
+        checkAgainst (melatonin::CompactRange::logWithLinearStart (0.0f, 10000.0f, 6.0f, 1000), melatonin::LogRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000));
+        checkAgainst (melatonin::CompactRange::decibels (-60.0f, 6.0f), melatonin::DecibelRange (-60.0f, 6.0f));
+        checkAgainst (melatonin::CompactRange::decibelsForHarmonic (3, -60.0f), melatonin::HarmonicDecibelRange (3, -60.0f));
+        checkAgainst (melatonin::CompactRange::intWithMidPoint (0, 100, 80), melatonin::IntRangeWithMidPoint (0, 100, 80));
+
+        // the blocks go through SIMD at the fast tiers
+        checkAgainst (melatonin::CompactRange::logWithLinearStart (0.0f, 10000.0f, 6.0f, 1000, 0.25f, melatonin::Accuracy::fast), melatonin::LogRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000, 0.25f, melatonin::Accuracy::fast));
+        checkAgainst (melatonin::CompactRange::decibelsForHarmonic (3, -60.0f, melatonin::Accuracy::fastest), melatonin::HarmonicDecibelRange (3, -60.0f, melatonin::Accuracy::fastest));
+    }
+
+    SECTION ("the int kind still snaps at the APVTS")
+    {
+        juce::NormalisableRange<float> converted = melatonin::CompactRange::intWithMidPoint (0, 100, 80);
+        CHECK (converted.interval == 1.0f);
+        CHECK (converted.snapToLegalValue (16.4f) == 16.0f);
+    }
+
+    SECTION ("a table of them is plain data")
+    {
+        static constexpr std::array<melatonin::CompactRange, 3> ranges { melatonin::CompactRange::log (0.0f, 15.0f), melatonin::CompactRange::decibels (-60.0f, 6.0f), melatonin::CompactRange::intWithMidPoint (0, 12, 6) };
+        STATIC_REQUIRE (std::is_trivially_copyable_v<melatonin::CompactRange>);
+        STATIC_REQUIRE (ranges[1].getKind() == melatonin::CompactRange::Kind::decibels);
+        CHECK (ranges[0].convertFrom0to1 (1.0f) == Catch::Approx (15.0f));
+        CHECK (ranges[2].convertFrom0to1 (0.5f) == 6.0f);
+    }
+}
+
+// the bytes per range for both, and what converting back at the APVTS costs
+TEST_CASE ("Melatonin Parameters compact range memory")
+{
+    auto report = [] (const std::string& name, auto makeFactory, auto makeCompact) {
+        const auto factoryBytes = melatonin::allocations::bytesPerObject (makeFactory);
+        const auto compactBytes = melatonin::allocations::bytesPerObject (makeCompact);
+
+        // at the APVTS a CompactRange becomes a NormalisableRange again, which shouldn't cost more than the factory's
+        const auto convertedBytes = melatonin::allocations::bytesPerObject ([&] { return juce::NormalisableRange<float> (makeCompact()); });
+        const auto allocationsBefore = melatonin::allocations::count;
+        {
+            juce::NormalisableRange<float> converted = makeCompact();
+            [[maybe_unused]] auto copy = converted;
+        }
+        const auto adapterAllocations = melatonin::allocations::count - allocationsBefore;
+
+        WARN (name << ": " << factoryBytes << " bytes as a NormalisableRange, " << compactBytes << " bytes as a CompactRange, "
+                   << convertedBytes << " bytes converted back, " << adapterAllocations << " allocations to convert and copy");
+        CHECK (compactBytes < factoryBytes);
+        CHECK (convertedBytes <= factoryBytes);
+        CHECK (adapterAllocations == 0u);
+    };
+
+    report ("linear", [] { return linearRange (-1.0f, 1.0f); }, [] { return melatonin::CompactRange::linear (-1.0f, 1.0f); });
+    report ("log", [] { return logarithmicRange (0.0f, 15.0f); }, [] { return melatonin::CompactRange::log (0.0f, 15.0f); });
+    report ("log with linear start", [] { return logarithmicRangeWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f); }, [] { return melatonin::CompactRange::logWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f); });
+    report ("decibels", [] { return decibelRange (-60.0f, 6.0f); }, [] { return melatonin::CompactRange::decibels (-60.0f, 6.0f); });
+    report ("harmonic decibels", [] { return decibelRangeForHarmonic (3); }, [] { return melatonin::CompactRange::decibelsForHarmonic (3); });
+    report ("int with midpoint", [] { return intRangeWithMidPoint (0, 100, 80); }, [] { return melatonin::CompactRange::intWithMidPoint (0, 100, 80); });
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters compact range benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("a block of 512 through a CompactRange")
+    {
+        std::vector<float> results (512);
+        for (auto [name, range] : { std::pair ("log, fast", melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f, melatonin::Accuracy::fast)),
+                 std::pair ("decibels", melatonin::CompactRange::decibels (-60.0f, 6.0f)),
+                 std::pair ("harmonic decibels, fast", melatonin::CompactRange::decibelsForHarmonic (3, -60.0f, melatonin::Accuracy::fast)) })
+        {
+            BENCHMARK (std::string ("CompactRange block of 512 ") + name)
+            {
+                range.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+                return results[0];
+            };
+        }
+    }
+}
+#endif
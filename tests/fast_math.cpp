@@ -0,0 +1,224 @@
+TEST_CASE ("Melatonin Parameters fast math")
+{
+    using melatonin::Accuracy;
+
+    // worst error over a sweep, relative for exp2 and pow10, absolute for the logs
+    auto measure = [] (auto&& approximate, auto&& exact, double from, double to, bool relative) {
+        double worst = 0;
+        for (int i = 0; i <= 100000; ++i)
+        {
+            auto x = (float) (from + (to - from) * i / 100000.0);
+            auto expected = exact ((double) x);
+            auto error = std::abs ((double) approximate (x) - expected);
+            worst = std::max (worst, relative ? error / std::abs (expected) : error);
+        }
+        return worst;
+    };
+
+    auto exp2Exact = [] (double x) { return std::exp2 (x); };
+    auto log2Exact = [] (double x) { return std::log2 (x); };
+    auto pow10Exact = [] (double x) { return std::pow (10.0, x); };
+    auto log10Exact = [] (double x) { return std::log10 (x); };
+
+    for (auto [accuracy, budget] : { std::pair (Accuracy::fast, 2e-6), std::pair (Accuracy::fastest, 2e-4) })
+    {
+        SECTION ("exp2 stays within budget")
+        {
+            CHECK (measure ([=] (float x) { return melatonin::fastmath::exp2 (x, accuracy); }, exp2Exact, -30.0, 30.0, true) < budget);
+        }
+
+        SECTION ("log2 stays within budget")
+        {
+            CHECK (measure ([=] (float x) { return melatonin::fastmath::log2 (x, accuracy); }, log2Exact, 1e-6, 2.0, false) < budget);
+            CHECK (measure ([=] (float x) { return melatonin::fastmath::log2 (x, accuracy); }, log2Exact, 2.0, 1e6, false) < budget);
+        }
+
+        SECTION ("pow10 stays within budget from -120 to +120dB")
+        {
+            CHECK (measure ([=] (float x) { return melatonin::fastmath::pow10 (x, accuracy); }, pow10Exact, -6.0, 6.0, true) < budget);
+        }
+
+        SECTION ("log10 stays within budget")
+        {
+            CHECK (measure ([=] (float x) { return melatonin::fastmath::log10 (x, accuracy); }, log10Exact, 1e-6, 1e6, false) < budget);
+        }
+
+        SECTION ("whole powers of 2 are exact")
+        {
+            CHECK (melatonin::fastmath::exp2 (0.0f, accuracy) == 1.0f);
+            CHECK (melatonin::fastmath::exp2 (6.0f, accuracy) == 64.0f);
+            CHECK (melatonin::fastmath::exp2 (-3.0f, accuracy) == 0.125f);
+            CHECK (melatonin::fastmath::log2 (1.0f, accuracy) == 0.0f);
+            CHECK (melatonin::fastmath::log2 (1024.0f, accuracy) == 10.0f);
+        }
+
+        SECTION ("block versions match the scalar versions")
+        {
+            std::vector<float> values, results (103);
+            for (int i = 0; i < 103; ++i)
+                values.push_back ((float) i * 0.37f - 10.0f);
+
+            melatonin::fastmath::exp2 (values.data(), results.data(), (int) values.size(), accuracy);
+            for (size_t i = 0; i < values.size(); ++i)
+                CHECK (results[i] == Catch::Approx (melatonin::fastmath::exp2 (values[i], accuracy)));
+
+            for (auto& value : values)
+                value = std::abs (value) + 0.001f;
+
+            melatonin::fastmath::log2 (values.data(), results.data(), (int) values.size(), accuracy);
+            for (size_t i = 0; i < values.size(); ++i)
+                CHECK (results[i] == Catch::Approx (melatonin::fastmath::log2 (values[i], accuracy)).margin (1e-6));
+        }
+
+        SECTION ("survives inputs outside of the supported range")
+        {
+            CHECK (melatonin::fastmath::exp2 (-1000.0f, accuracy) == 0.0f);
+            CHECK (melatonin::fastmath::exp2 (-std::numeric_limits<float>::infinity(), accuracy) == 0.0f);
+            CHECK (std::isfinite (melatonin::fastmath::exp2 (1000.0f, accuracy)));
+            CHECK (melatonin::fastmath::log2 (0.0f, accuracy) == Catch::Approx (-126.0f));
+            CHECK (melatonin::fastmath::log2 (-1.0f, accuracy) == Catch::Approx (-126.0f));
+
+            // NaN comes out the same in a block (SIMD lanes and the scalar tail) as one value at a time
+            const auto nan = std::numeric_limits<float>::quiet_NaN();
+            CHECK (melatonin::fastmath::exp2 (nan, accuracy) == 0.0f);
+            CHECK (melatonin::fastmath::log2 (nan, accuracy) == Catch::Approx (-126.0f));
+
+            const std::vector<float> nans (7, nan);
+            std::vector<float> results (nans.size());
+            melatonin::fastmath::exp2 (nans.data(), results.data(), (int) nans.size(), accuracy);
+            for (auto result : results)
+                CHECK (result == 0.0f);
+
+            melatonin::fastmath::log2 (nans.data(), results.data(), (int) nans.size(), accuracy);
+            for (auto result : results)
+                CHECK (result == melatonin::fastmath::log2 (nan, accuracy));
+        }
+    }
+
+    SECTION ("exact is the std functions")
+    {
+        CHECK (melatonin::fastmath::exp2 (0.3f, Accuracy::exact) == std::exp2 (0.3f));
+        CHECK (melatonin::fastmath::log2 (0.3f, Accuracy::exact) == std::log2 (0.3f));
+        CHECK (melatonin::fastmath::pow10 (0.3f, Accuracy::exact) == std::pow (10.0f, 0.3f));
+        CHECK (melatonin::fastmath::log10 (0.3f, Accuracy::exact) == std::log10 (0.3f));
+    }
+}
+
+TEST_CASE ("Melatonin Parameters ranges at each accuracy")
+{
+    using melatonin::Accuracy;
+
+    // compare against the exact range where it matters for a knob: how far off the normalized position is
+    auto checkAgainstExact = [] (const juce::NormalisableRange<float>& exact, const juce::NormalisableRange<float>& approximate, float budget) {
+        for (int i = 0; i <= 1000; ++i)
+        {
+            auto normalized = (float) i / 1000.0f;
+            auto unnormalized = exact.convertFrom0to1 (normalized);
+            CHECK (exact.convertTo0to1 (approximate.convertFrom0to1 (normalized)) == Catch::Approx (normalized).margin (budget));
+            CHECK (approximate.convertTo0to1 (unnormalized) == Catch::Approx (exact.convertTo0to1 (unnormalized)).margin (budget));
+        }
+    };
+
+    for (auto [accuracy, budget] : { std::pair (Accuracy::fast, 1e-5f), std::pair (Accuracy::fastest, 1e-3f) })
+    {
+        SECTION ("factories")
+        {
+            checkAgainstExact (logarithmicRange (0.0f, 15.0f), logarithmicRange (0.0f, 15.0f, 6.0f, accuracy), budget);
+            checkAgainstExact (logarithmicRange (20.0f, 20000.0f, 10.0f), logarithmicRange (20.0f, 20000.0f, 10.0f, accuracy), budget);
+            checkAgainstExact (logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000), logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000, 0.25f, accuracy), budget);
+            checkAgainstExact (reversedLogarithmicRange (0.0f, 15.0f), reversedLogarithmicRange (0.0f, 15.0f, 6.0f, accuracy), budget);
+        }
+
+        SECTION ("harmonic decibel ranges are off by a fraction of a dB at most")
+        {
+            auto exact = decibelRangeForHarmonic (3);
+            auto approximate = decibelRangeForHarmonic (3, -100.f, accuracy);
+            for (int i = 1; i <= 1000; ++i)
+            {
+                auto normalized = (float) i / 1000.0f;
+                CHECK (approximate.convertFrom0to1 (normalized) == Catch::Approx (exact.convertFrom0to1 (normalized)).margin (budget * 10));
+                CHECK (approximate.convertTo0to1 (exact.convertFrom0to1 (normalized)) == Catch::Approx (normalized).epsilon (budget));
+            }
+            CHECK (approximate.convertFrom0to1 (0.0f) == -100.0f);
+            CHECK (approximate.convertTo0to1 (-100.0f) == 0.0f);
+        }
+
+        SECTION ("range types and their blocks")
+        {
+            auto exact = melatonin::LogRange (0.0f, 15.0f);
+            auto approximate = melatonin::LogRange (0.0f, 15.0f, 6.0f, accuracy);
+            checkAgainstExact (exact, approximate, budget);
+
+            std::vector<float> values, results (257);
+            for (int i = 0; i < 257; ++i)
+                values.push_back ((float) i / 256.0f);
+
+            approximate.convertFrom0to1 (values.data(), results.data(), (int) values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                CHECK (results[i] == Catch::Approx (approximate.convertFrom0to1 (values[i])).margin (1e-6));
+
+            auto harmonic = melatonin::HarmonicDecibelRange (2, -60.0f, accuracy);
+            harmonic.convertFrom0to1 (values.data(), results.data(), (int) values.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                CHECK (results[i] == Catch::Approx (harmonic.convertFrom0to1 (values[i])).margin (1e-5));
+
+            harmonic.convertTo0to1 (results.data(), results.data(), (int) results.size());
+            for (size_t i = 0; i < values.size(); ++i)
+                CHECK (results[i] == Catch::Approx (harmonic.convertTo0to1 (harmonic.convertFrom0to1 (values[i]))).margin (1e-6));
+            CHECK (results[0] == 0.0f);
+        }
+
+        SECTION ("gain and decibel blocks")
+        {
+            std::vector<float> gains { -1.0f, 0.0f, 1e-6f, 0.001f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f }, decibels (gains.size()), roundTrip (gains.size());
+            melatonin::fastmath::gainToDecibels (gains.data(), decibels.data(), (int) gains.size(), -100.0f, accuracy);
+            for (size_t i = 0; i < gains.size(); ++i)
+                CHECK (decibels[i] == Catch::Approx (juce::Decibels::gainToDecibels (gains[i], -100.0f)).margin (budget * 10));
+
+            melatonin::fastmath::decibelsToGain (decibels.data(), roundTrip.data(), (int) decibels.size(), -100.0f, accuracy);
+            for (size_t i = 0; i < gains.size(); ++i)
+                CHECK (roundTrip[i] == Catch::Approx (juce::Decibels::decibelsToGain (decibels[i], -100.0f)).epsilon (budget));
+            CHECK (roundTrip[0] == 0.0f);
+            CHECK (roundTrip[1] == 0.0f);
+        }
+    }
+
+    SECTION ("exact gain and decibel blocks are juce::Decibels")
+    {
+        std::vector<float> gains { -1.0f, 0.0f, 0.001f, 0.5f, 1.0f, 2.0f }, decibels (gains.size()), roundTrip (gains.size());
+        melatonin::fastmath::gainToDecibels (gains.data(), decibels.data(), (int) gains.size(), -100.0f, Accuracy::exact);
+        melatonin::fastmath::decibelsToGain (decibels.data(), roundTrip.data(), (int) decibels.size(), -100.0f, Accuracy::exact);
+        for (size_t i = 0; i < gains.size(); ++i)
+        {
+            CHECK (decibels[i] == Catch::Approx (juce::Decibels::gainToDecibels (gains[i], -100.0f)));
+            CHECK (roundTrip[i] == Catch::Approx (juce::Decibels::decibelsToGain (decibels[i], -100.0f)));
+        }
+    }
+
+    SECTION ("exact is the default and doesn't change anything")
+    {
+        auto range = melatonin::LogRange (0.0f, 15.0f);
+        CHECK (range.getAccuracy() == Accuracy::exact);
+        CHECK (logarithmicRange (0.0f, 15.0f, 6.0f, Accuracy::exact).convertFrom0to1 (0.3f) == logarithmicRange (0.0f, 15.0f).convertFrom0to1 (0.3f));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters fast math benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("gainToDecibels, a block of 512")
+    {
+        std::vector<float> results (512);
+        for (auto [name, accuracy] : { std::pair ("exact", melatonin::Accuracy::exact), std::pair ("fast", melatonin::Accuracy::fast), std::pair ("fastest", melatonin::Accuracy::fastest) })
+        {
+            BENCHMARK (std::string ("gainToDecibels block of 512 ") + name)
+            {
+                melatonin::fastmath::gainToDecibels (normalized.data(), results.data(), (int) results.size(), -100.0f, accuracy);
+                return results[0];
+            };
+        }
+    }
+}
+#endif
@@ -0,0 +1,165 @@
+// Doubles should come out like juce::String (double, decimals), floats like juce::String (float, decimals)
+TEMPLATE_TEST_CASE ("Melatonin Parameters formatters", "", float, double)
+{
+    // What the stringFrom* lambdas did before they went through the formatters
+    auto timeReference = [] (TestType value) {
+        if ((value < 0.0) || (value == 0.0))
+            return juce::String ("0ms");
+        else if (value < 0.5)
+            return juce::String (value * 1000, 1).dropLastCharacters (2) + "ms";
+        return juce::String (value, 2) + "s";
+    };
+
+    auto hzReference = [] (TestType value) {
+        if (value >= 1500.f)
+            return juce::String (value / 1000.0f, 1) + " kHz";
+        if (value < 2.0f)
+            return juce::String (value, 2) + " Hz";
+        if (value < 10.0f)
+            return juce::String (value, 1) + " Hz";
+        return juce::String (value, 1).dropLastCharacters (2) + " Hz";
+    };
+
+    auto dBWithOffReference = [] (TestType value) {
+        if (juce::approximatelyEqual (value, (TestType) -64))
+            return juce::String ("OFF");
+        return juce::String (value, 1) + "db";
+    };
+
+    auto percentWithDigitsReference = [] (TestType value) {
+        if (juce::approximatelyEqual (value, (TestType) 0))
+            return juce::String ("OFF");
+        return juce::String (value * 100.0f, 2) + "%";
+    };
+
+    // values right on and around rounding boundaries, plus a sweep over each helper's usual range
+    auto valuesBetween = [] (TestType start, TestType end) {
+        std::vector<TestType> values;
+        for (int i = 0; i <= 20000; ++i)
+            values.push_back (start + (end - start) * (TestType) i / 20000);
+        for (auto literal : { 0.0f, 0.0005f, 0.0015f, 0.005f, 0.05f, 0.125f, 0.4995f, 0.49996f, 0.5f, 1.005f, 1.995f, 2.0f, 9.95f, 10.0f, 1499.95f, 1500.0f })
+        {
+            const auto boundary = (TestType) literal;
+            for (auto value : { boundary, std::nextafter (boundary, (TestType) -1e9), std::nextafter (boundary, (TestType) 1e9), -boundary })
+                values.push_back (value);
+        }
+        return values;
+    };
+
+    SECTION ("match the original juce::String code byte for byte")
+    {
+        for (auto value : valuesBetween (-1.0f, 20.0f))
+        {
+            CHECK (stringFromTimeValue (value) == timeReference (value));
+            CHECK (stringFromPercentValue (value) == juce::String (value * 100.0f, 1).dropLastCharacters (2) + "%");
+            CHECK (stringFromPercentValueWithDigits<2> (value) == percentWithDigitsReference (value));
+            CHECK (stringFrom0to1 (value) == juce::String (value, 4));
+            CHECK (stringFrom0to1 (value, 1) == juce::String (value, 1));
+            CHECK (stringFrom0to1 (value, 6) == juce::String (value, 6));
+        }
+
+        for (auto value : valuesBetween (-100.0f, 24.0f))
+        {
+            CHECK (stringFromDBValue (value) == juce::String (value, 1) + "db");
+            CHECK (stringFromDBValueWithOffAt64 (value) == dBWithOffReference (value));
+            CHECK (stringFromIntValue (value) == juce::String ((int) value));
+            CHECK (stringFromSemiValue (value) == juce::String ((int) value) + " semi");
+        }
+
+        for (auto value : valuesBetween (0.0f, 22000.0f))
+            CHECK (stringFromHzValue (value) == hzReference (value));
+
+        CHECK (stringFromDBValueWithOffAt64 ((TestType) -64) == "OFF");
+        CHECK (stringFromPercentValueWithDigits<2> ((TestType) 0) == "OFF");
+    }
+
+    SECTION ("match juce::String where it falls back to std::ostream")
+    {
+        for (auto literal : { 1e21f, -3e25f, 0.123456789f, 12345.678f })
+        {
+            const auto value = (TestType) literal;
+            CHECK (stringFrom0to1 (value, 8) == juce::String (value, 8));
+            CHECK (stringFrom0to1 (value, 0) == juce::String (value, 0));
+            CHECK (stringFromDBValue (value) == juce::String (value, 1) + "db");
+        }
+
+        // a host that sets a locale with a decimal comma doesn't change anything (when that locale is installed)
+        const std::string previous = std::setlocale (LC_NUMERIC, nullptr);
+        for (auto name : { "de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "German" })
+        {
+            if (std::setlocale (LC_NUMERIC, name) != nullptr)
+            {
+                CHECK (stringFrom0to1 ((TestType) 0.5f, 8) == "0.50000000");
+                CHECK (stringFrom0to1 ((TestType) 1.5f, 0) == "1.5");
+                break;
+            }
+        }
+        std::setlocale (LC_NUMERIC, previous.c_str());
+    }
+
+    SECTION ("write into a std::array without allocating")
+    {
+        std::array<char, 16> text {};
+        CHECK (melatonin::format<melatonin::formatters::Hz> (1500.0f, text) == "1.5 kHz");
+        CHECK (melatonin::format<melatonin::formatters::Time> (0.25f, text) == "250ms");
+        CHECK (melatonin::format<melatonin::formatters::Decibels> (-6.123f, text) == "-6.1db");
+        CHECK (std::string_view (text.data()) == "-6.1db");
+    }
+
+    SECTION ("truncate to the buffer, always null terminated")
+    {
+        char text[5];
+        CHECK (melatonin::format<melatonin::formatters::Hz> (440.0f, text, sizeof (text)) == 4u);
+        CHECK (std::string_view (text) == "440 ");
+    }
+
+    SECTION ("quantize to what's displayed")
+    {
+        using melatonin::formatters::Decibels;
+        using melatonin::formatters::Time;
+        CHECK (Decibels::quantize (-6.11f) == Decibels::quantize (-6.09f));
+        CHECK (Decibels::quantize (-6.11f) != Decibels::quantize (-6.16f));
+        CHECK (Decibels::quantize (0.01f) != Decibels::quantize (-0.01f)); // "0.0db" vs "-0.0db"
+        CHECK (Time::quantize (0.4999f) != Time::quantize (0.5f));
+        CHECK (Time::quantize (0.1111f) == Time::quantize (0.11115f));
+    }
+
+    SECTION ("doubles are rounded as doubles")
+    {
+        // 0.45 as a float is 0.449999988, as a double it's 0.45000000000000001
+        CHECK (stringFrom0to1 (0.45, 1) == "0.5");
+        CHECK (stringFrom0to1 (0.45f, 1) == "0.4");
+        CHECK (stringFromDBValue (-6.05) == juce::String (-6.05, 1) + "db");
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters formatter benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("into a buffer")
+    {
+        auto benchmarkFormatter = [&] (const std::string& name, auto formatter, const juce::NormalisableRange<float>& range) {
+            using Formatter = decltype (formatter);
+            std::vector<float> values;
+            for (auto value : normalized)
+                values.push_back (range.convertFrom0to1 (value));
+
+            std::array<char, 32> text;
+            size_t i = 0;
+            BENCHMARK ("melatonin::format<" + name + ">")
+            {
+                return melatonin::format<Formatter> (values[i++ & 1023], text).size();
+            };
+
+            CHECK (melatonin::allocations::perCall ([&] (int n) { return melatonin::format<Formatter> (values[(size_t) n], text).size(); }) == 0);
+        };
+
+        benchmarkFormatter ("Time", melatonin::formatters::Time(), logarithmicRange (0.0f, 15.0f));
+        benchmarkFormatter ("Decibels", melatonin::formatters::Decibels(), decibelRange (-30.0f, 0.0f));
+        benchmarkFormatter ("Percent", melatonin::formatters::Percent(), linearRange (0.0f, 1.0f));
+        benchmarkFormatter ("Hz", melatonin::formatters::Hz(), logarithmicRange (20.0f, 20000.0f, 10.0f));
+    }
+}
+#endif
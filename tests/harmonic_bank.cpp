@@ -0,0 +1,99 @@
+TEST_CASE ("Melatonin Parameters harmonic bank")
+{
+    melatonin::HarmonicBank bank (64);
+    bank.setMinimum (10, -60.0f);
+    for (size_t i = 0; i < bank.size(); ++i)
+        bank.setNormalized (i, (float) ((i * 37) % 64) / 63.0f);
+
+    // a couple of values outside 0-1, the ranges clamp them
+    bank.setNormalized (20, 1.5f);
+    bank.setNormalized (21, -0.5f);
+
+    std::vector<float> decibels (bank.size()), gains (bank.size());
+
+    SECTION ("matches decibelRangeForHarmonic for every harmonic")
+    {
+        bank.convertFrom0to1 (decibels.data());
+        bank.gainFrom0to1 (gains.data());
+        for (size_t i = 0; i < bank.size(); ++i)
+        {
+            auto range = decibelRangeForHarmonic (i + 1, bank.getMinimum (i));
+            auto dB = range.convertFrom0to1 (bank.getNormalized (i));
+            CHECK (decibels[i] == Catch::Approx (dB).margin (1e-4));
+            CHECK (gains[i] == Catch::Approx (juce::Decibels::decibelsToGain (dB, bank.getMinimum (i))).margin (1e-7));
+            CHECK (bank.getRange (i).end == Catch::Approx (range.end));
+        }
+
+        CHECK (decibels[0] == Catch::Approx (-100.0f));
+        CHECK (gains[0] == 0.0f);
+        CHECK (decibels[21] == Catch::Approx (-100.0f));
+        CHECK (decibels[20] == Catch::Approx (juce::Decibels::gainToDecibels (1.0f / 21.0f)));
+    }
+
+    SECTION ("converts dB back, clamped to 1 like the ranges")
+    {
+        bank.convertFrom0to1 (decibels.data());
+        std::vector<float> expected;
+        for (size_t i = 0; i < bank.size(); ++i)
+            expected.push_back (decibelRangeForHarmonic (i + 1, bank.getMinimum (i)).convertTo0to1 (decibels[i]));
+
+        // a dB a little over the harmonic's maximum still lands on 1
+        decibels[20] += 0.5f;
+        expected[20] = 1.0f;
+
+        bank.convertTo0to1 (decibels.data());
+        for (size_t i = 0; i < bank.size(); ++i)
+            CHECK (bank.getNormalized (i) == Catch::Approx (expected[i]).margin (1e-5));
+    }
+
+    SECTION ("fast accuracy stays within a fraction of a dB")
+    {
+        melatonin::HarmonicBank fast (64, -100.0f, melatonin::Accuracy::fast);
+        std::copy (bank.getNormalizedValues(), bank.getNormalizedValues() + bank.size(), fast.getNormalizedValues());
+        fast.setMinimum (10, -60.0f);
+
+        std::vector<float> fastDecibels (fast.size());
+        bank.convertFrom0to1 (decibels.data());
+        fast.convertFrom0to1 (fastDecibels.data());
+        for (size_t i = 0; i < bank.size(); ++i)
+            CHECK (fastDecibels[i] == Catch::Approx (decibels[i]).margin (1e-3));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters harmonic bank benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("256 harmonics")
+    {
+        std::vector<juce::NormalisableRange<float>> ranges;
+        melatonin::HarmonicBank bank (256);
+        for (size_t i = 0; i < 256; ++i)
+        {
+            ranges.push_back (decibelRangeForHarmonic (i + 1));
+            bank.setNormalized (i, normalized[i]);
+        }
+
+        std::vector<float> gains (256);
+        BENCHMARK ("256 decibelRangeForHarmonic to gain")
+        {
+            for (size_t i = 0; i < 256; ++i)
+                gains[i] = juce::Decibels::decibelsToGain (ranges[i].convertFrom0to1 (normalized[i]));
+            return gains[0];
+        };
+
+        BENCHMARK ("HarmonicBank (256) gainFrom0to1")
+        {
+            bank.gainFrom0to1 (gains.data());
+            return gains[0];
+        };
+
+        BENCHMARK ("HarmonicBank (256) convertFrom0to1")
+        {
+            bank.convertFrom0to1 (gains.data());
+            return gains[0];
+        };
+    }
+}
+#endif
@@ -0,0 +1,117 @@
+TEST_CASE ("Melatonin Parameters label table")
+{
+    SECTION ("has the same labels and positions as formatting each legal value")
+    {
+        auto range = intRangeWithMidPoint (0, 127, 100);
+        melatonin::LabelTable midi (range, stringFromIntValue);
+        REQUIRE (midi.size() == 128u);
+        REQUIRE (midi.getLabels().size() == 128);
+
+        for (size_t i = 0; i < midi.size(); ++i)
+        {
+            CHECK (midi.getValue (i) == (float) i);
+            CHECK (midi.getLabel (i) == stringFromIntValue ((float) i));
+            CHECK (midi.getNormalized (i) == range.convertTo0to1 ((float) i));
+        }
+    }
+
+    SECTION ("looks up the label of the value it would snap to")
+    {
+        juce::NormalisableRange<float> range (-24.0f, 24.0f, 1.0f);
+        melatonin::LabelTable semitones (range, stringFromSemiValue);
+        CHECK (semitones.size() == 49u);
+
+        for (int i = -300; i <= 300; ++i)
+        {
+            // stay off the exact halfway points, where snapping and formatting disagree about rounding
+            auto value = (float) i * 0.0999f;
+            CHECK (semitones.labelFor (value) == stringFromSemiValue (range.snapToLegalValue (value)));
+            CHECK (semitones.labelForNormalized (range.convertTo0to1 (value)) == stringFromSemiValue (range.snapToLegalValue (value)));
+        }
+
+        CHECK (semitones.labelFor (-100.0f) == "-24 semi");
+        CHECK (semitones.labelFor (100.0f) == "24 semi");
+        CHECK (semitones.labelForNormalized (0.5f) == "0 semi");
+
+        // NaN goes to the first label, and anything too big for a size_t to the last
+        CHECK (semitones.indexOf (std::numeric_limits<float>::quiet_NaN()) == 0u);
+        CHECK (semitones.indexOf (std::numeric_limits<float>::infinity()) == 48u);
+        CHECK (semitones.indexOf (-std::numeric_limits<float>::infinity()) == 0u);
+        CHECK (semitones.indexOf (1e30f) == 48u);
+        CHECK (semitones.labelFor (std::numeric_limits<float>::max()) == "24 semi");
+    }
+
+    SECTION ("an end that isn't on a step snaps to the last step, like NormalisableRange")
+    {
+        juce::NormalisableRange<float> range (0.0f, 10.0f, 3.0f);
+        melatonin::LabelTable steps (range, stringFromIntValue);
+        REQUIRE (steps.size() == 4u);
+        CHECK (steps.getValue (3) == 9.0f);
+        CHECK (steps.labelFor (10.0f) == stringFromIntValue (range.snapToLegalValue (10.0f)));
+        CHECK (steps.labelFor (9.8f) == "9");
+
+        // and an interval that doesn't divide evenly in floats
+        melatonin::LabelTable tenths (juce::NormalisableRange<float> (0.0f, 1.0f, 0.1f), stringFrom0to1);
+        CHECK (tenths.size() == 11u);
+        CHECK (tenths.getLabel (10) == stringFrom0to1 (1.0f));
+    }
+
+    SECTION ("works as the parameter's stringFrom lambda")
+    {
+        auto range = intRangeWithMidPoint (0, 127, 100);
+        auto stringFrom = melatonin::labelledStringFrom (range, stringFromIntValue);
+        CHECK (stringFrom (64.0f, 5) == "64");
+        CHECK (stringFrom (range.convertFrom0to1 (1.0f)) == "127");
+
+        std::function<juce::String (float, int)> valueToText = stringFrom;
+        CHECK (valueToText (3.0f, 5) == "3");
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters label table benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("through a label table")
+    {
+        // a host polling getText on a 128 step MIDI control
+        const auto range = intRangeWithMidPoint (0, 127, 100);
+        size_t i = 0;
+        BENCHMARK ("getText, stringFromIntValue")
+        {
+            return stringFromIntValue (range.convertFrom0to1 (normalized[i++ & 1023]), 5);
+        };
+
+        const melatonin::LabelTable midi (range, stringFromIntValue);
+        BENCHMARK ("getText, LabelTable::labelForNormalized")
+        {
+            return midi.labelForNormalized (normalized[i++ & 1023]).length();
+        };
+
+        // filling a combo box and drawing tick marks for a 48 step semitone control
+        const juce::NormalisableRange<float> semitoneRange (-24.0f, 24.0f, 1.0f);
+        BENCHMARK ("49 labels and positions, formatted")
+        {
+            juce::StringArray labels;
+            float positions = 0;
+            for (int semitone = -24; semitone <= 24; ++semitone)
+            {
+                labels.add (stringFromSemiValue ((float) semitone));
+                positions += semitoneRange.convertTo0to1 ((float) semitone);
+            }
+            return positions + (float) labels.size();
+        };
+
+        const melatonin::LabelTable semitones (semitoneRange, stringFromSemiValue);
+        BENCHMARK ("49 labels and positions, LabelTable")
+        {
+            juce::StringArray labels = semitones.getLabels();
+            float positions = 0;
+            for (size_t index = 0; index < semitones.size(); ++index)
+                positions += semitones.getNormalized (index);
+            return positions + (float) labels.size();
+        };
+    }
+}
+#endif
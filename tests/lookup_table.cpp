@@ -0,0 +1,133 @@
+TEST_CASE ("Melatonin Parameters lookup table ranges")
+{
+    SECTION ("a linear range is reproduced exactly")
+    {
+        auto table = melatonin::LookupTableRange<16> (linearRange (-1.0f, 1.0f));
+        CHECK (table.getFrom0to1Error().maxAbsolute < 1e-6f);
+        CHECK (table.getTo0to1Error().maxAbsolute < 1e-6f);
+        CHECK (table.convertFrom0to1 (0.5f) == Catch::Approx (0.0f).margin (1e-6));
+        CHECK (table.convertTo0to1 (0.5f) == Catch::Approx (0.75f));
+    }
+
+    SECTION ("hits the ends of the range")
+    {
+        auto table = melatonin::LookupTableRange<1024> (logarithmicRange (0.0f, 15.0f));
+        CHECK (table.convertFrom0to1 (0.0f) == Catch::Approx (0.0f));
+        CHECK (table.convertFrom0to1 (1.0f) == Catch::Approx (15.0f));
+        CHECK (table.convertTo0to1 (0.0f) == Catch::Approx (0.0f));
+        CHECK (table.convertTo0to1 (15.0f) == Catch::Approx (1.0f));
+    }
+
+    SECTION ("clamps out of range input like NormalisableRange")
+    {
+        auto table = melatonin::LookupTableRange<1024> (logarithmicRange (0.0f, 15.0f));
+        CHECK (table.convertFrom0to1 (-1.0f) == Catch::Approx (0.0f));
+        CHECK (table.convertFrom0to1 (2.0f) == Catch::Approx (15.0f));
+        CHECK (table.convertTo0to1 (20.0f) == Catch::Approx (1.0f));
+    }
+
+    SECTION ("NaN reads the start of the table instead of a random index")
+    {
+        auto table = melatonin::LookupTableRange<1024> (logarithmicRange (0.0f, 15.0f), melatonin::Interpolation::cubic);
+        const auto nan = std::numeric_limits<float>::quiet_NaN();
+        CHECK (table.convertFrom0to1 (nan) == table.convertFrom0to1 (0.0f));
+        CHECK (table.convertTo0to1 (nan) == table.convertTo0to1 (0.0f));
+
+        std::array<float, 5> values { nan, 0.5f, nan, nan, nan }, results {};
+        table.convertFrom0to1 (values.data(), results.data(), (int) values.size());
+        CHECK (results[0] == table.convertFrom0to1 (0.0f));
+        CHECK (results[1] == table.convertFrom0to1 (0.5f));
+        CHECK (results[4] == table.convertFrom0to1 (0.0f));
+    }
+
+    SECTION ("the reported error is the worst error")
+    {
+        auto exact = logarithmicRange (20.0f, 20000.0f, 10.0f);
+
+        for (auto interpolation : { melatonin::Interpolation::linear, melatonin::Interpolation::cubic })
+        {
+            auto table = melatonin::LookupTableRange<1024> (exact, interpolation);
+
+            juce::Random random (42);
+            for (int i = 0; i < 10000; ++i)
+            {
+                // allow for a few floats of rounding in the exact value
+                auto normalized = random.nextFloat();
+                auto expected = exact.convertFrom0to1 (normalized);
+                CHECK (std::abs (table.convertFrom0to1 (normalized) - expected) <= table.getFrom0to1Error().maxAbsolute * 1.1f + expected * 1e-6f);
+            }
+        }
+    }
+
+    SECTION ("cubic interpolation beats linear on curves")
+    {
+        auto exact = logarithmicRange (20.0f, 20000.0f, 10.0f);
+        auto linear = melatonin::LookupTableRange<1024> (exact, melatonin::Interpolation::linear);
+        auto cubic = melatonin::LookupTableRange<1024> (exact, melatonin::Interpolation::cubic);
+
+        CHECK (cubic.getFrom0to1Error().maxAbsolute < linear.getFrom0to1Error().maxAbsolute);
+        CHECK (cubic.getTo0to1Error().maxAbsolute < linear.getTo0to1Error().maxAbsolute);
+        CHECK (linear.getFrom0to1Error().maxRelative < 1e-5f);
+        CHECK (cubic.getFrom0to1Error().maxRelative < 2e-6f);
+    }
+
+    SECTION ("decibelRange stays within a hundredth of a dB")
+    {
+        auto table = melatonin::LookupTableRange<4096> (decibelRange (-60.0f, 12.0f));
+        CHECK (table.getFrom0to1Error().maxAbsolute < 0.01f);
+        CHECK (table.getTo0to1Error().maxAbsolute < 1e-4f);
+    }
+
+    SECTION ("more points means less error")
+    {
+        auto exact = logarithmicRange (0.0f, 44100.0f, 10.0f);
+        CHECK (melatonin::LookupTableRange<4096> (exact).getTo0to1Error().maxAbsolute < melatonin::LookupTableRange<1024> (exact).getTo0to1Error().maxAbsolute);
+    }
+
+    SECTION ("block conversion matches the scalar lookup")
+    {
+        auto table = melatonin::LookupTableRange<1024> (logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000.0f), melatonin::Interpolation::cubic);
+
+        std::array<float, 64> normalized {}, unnormalized {}, backAgain {};
+        for (size_t i = 0; i < normalized.size(); ++i)
+            normalized[i] = (float) i / 63.0f;
+
+        table.convertFrom0to1 (normalized.data(), unnormalized.data(), (int) normalized.size());
+        table.convertTo0to1 (unnormalized.data(), backAgain.data(), (int) normalized.size());
+        for (size_t i = 0; i < normalized.size(); ++i)
+        {
+            CHECK (unnormalized[i] == table.convertFrom0to1 (normalized[i]));
+            CHECK (backAgain[i] == table.convertTo0to1 (unnormalized[i]));
+        }
+
+        // across several chunks with a leftover, out of range values included, in place
+        std::vector<float> values (203), inPlace;
+        for (size_t i = 0; i < values.size(); ++i)
+            values[i] = (float) i / 150.0f - 0.2f;
+        inPlace = values;
+        table.convertFrom0to1 (inPlace.data(), inPlace.data(), (int) inPlace.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            CHECK (inPlace[i] == table.convertFrom0to1 (values[i]));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters lookup table benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("a block of 512 through a LookupTableRange")
+    {
+        std::vector<float> results (512);
+        for (auto [name, interpolation] : { std::pair ("linear", melatonin::Interpolation::linear), std::pair ("cubic", melatonin::Interpolation::cubic) })
+        {
+            const auto table = melatonin::LookupTableRange<1024> (logarithmicRange (20.0f, 20000.0f, 10.0f), interpolation);
+            BENCHMARK (std::string ("LookupTableRange block of 512 ") + name)
+            {
+                table.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+                return results[0];
+            };
+        }
+    }
+}
+#endif
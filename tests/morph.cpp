@@ -0,0 +1,195 @@
+TEST_CASE ("Melatonin Parameters morph")
+{
+    const auto frequency = melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f);
+    const auto gain = melatonin::CompactRange::decibels (-60.0f, 6.0f);
+    const auto voices = melatonin::CompactRange::intWithMidPoint (1, 8, 4);
+
+    auto makeMorph = [&] {
+        melatonin::MorphEngine<> morph;
+        CHECK (morph.addParameters (frequency, 4) == 0);
+        CHECK (morph.addParameters (gain, 2) == 4);
+        CHECK (morph.addParameters (voices) == 6);
+        CHECK (morph.addParameters (frequency) == 7);
+        CHECK (morph.getNumParameters() == 8);
+        return morph;
+    };
+
+    const std::array<float, 8> a { 0.0f, 0.1f, 0.2f, 0.3f, 0.0f, 1.0f, 0.0f, 0.25f };
+    const std::array<float, 8> b { 1.0f, 0.9f, 0.8f, 0.7f, 1.0f, 0.0f, 1.0f, 0.75f };
+    std::array<float, 8> plain;
+
+    SECTION ("the ends are the snapshots")
+    {
+        auto morph = makeMorph();
+        morph.addSnapshot (a.data());
+        morph.addSnapshot (b.data());
+
+        morph.process (0.0f, plain.data());
+        CHECK (plain[0] == Catch::Approx (20.0f));
+        CHECK (plain[5] == Catch::Approx (6.0f));
+        CHECK (plain[6] == 1.0f);
+
+        morph.process (1.0f, plain.data());
+        CHECK (plain[0] == Catch::Approx (20000.0f));
+        CHECK (plain[5] == Catch::Approx (-60.0f));
+        CHECK (plain[6] == 8.0f);
+    }
+
+    SECTION ("blends in the normalized domain")
+    {
+        auto morph = makeMorph();
+        morph.addSnapshot (a.data());
+        morph.addSnapshot (b.data());
+
+        for (auto position : { 0.1f, 0.25f, 0.4f, 0.6f, 0.9f })
+        {
+            morph.process (position, plain.data());
+            for (size_t i : { 0u, 1u, 2u, 3u, 7u })
+                CHECK (plain[i] == Catch::Approx (frequency.convertFrom0to1 (a[i] + (b[i] - a[i]) * position)).epsilon (1e-5));
+            for (size_t i : { 4u, 5u })
+                CHECK (plain[i] == Catch::Approx (gain.convertFrom0to1 (a[i] + (b[i] - a[i]) * position)).margin (1e-4));
+
+            CHECK (morph.getNormalized()[1] == Catch::Approx (a[1] + (b[1] - a[1]) * position));
+        }
+
+        // halfway between 20Hz and 20kHz is halfway on the knob, not 10kHz
+        morph.process (0.5f, plain.data());
+        CHECK (plain[0] == Catch::Approx (frequency.convertFrom0to1 (0.5f)));
+        CHECK (plain[0] < 1000.0f);
+    }
+
+    SECTION ("stepped parameters switch halfway")
+    {
+        auto morph = makeMorph();
+        morph.addSnapshot (a.data());
+        morph.addSnapshot (b.data());
+
+        morph.process (0.49f, plain.data());
+        CHECK (plain[6] == 1.0f);
+        morph.process (0.51f, plain.data());
+        CHECK (plain[6] == 8.0f);
+
+        // a range can be made to step (or blend) whatever it is
+        melatonin::MorphEngine<> forced;
+        forced.addParameters (frequency, 1, melatonin::MorphMode::stepped);
+        forced.addParameters (voices, 1, melatonin::MorphMode::blend);
+        const std::array<float, 2> low { 0.0f, 0.0f }, high { 1.0f, 1.0f };
+        forced.addSnapshot (low.data());
+        forced.addSnapshot (high.data());
+        forced.process (0.25f, plain.data());
+        CHECK (plain[0] == Catch::Approx (20.0f));
+        CHECK (plain[1] == Catch::Approx (voices.convertFrom0to1 (0.25f)));
+    }
+
+    SECTION ("more than two snapshots")
+    {
+        auto morph = makeMorph();
+        const std::array<float, 8> c { 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f };
+        const std::array<float, 8> d { 0.2f, 0.2f, 0.2f, 0.2f, 0.2f, 0.2f, 0.2f, 0.2f };
+        for (auto* snapshot : { &a, &b, &c, &d })
+            morph.addSnapshot (snapshot->data());
+
+        // along the chain, a quarter of the way between b and c
+        morph.process (1.25f / 3.0f, plain.data());
+        CHECK (morph.getNormalized()[0] == Catch::Approx (0.75f * b[0] + 0.25f * c[0]));
+        CHECK (plain[6] == 8.0f);
+
+        // the corners of an XY pad
+        morph.processXY (0.0f, 1.0f, plain.data());
+        CHECK (morph.getNormalized()[2] == Catch::Approx (c[2]));
+        morph.processXY (0.5f, 0.5f, plain.data());
+        CHECK (morph.getNormalized()[3] == Catch::Approx ((a[3] + b[3] + c[3] + d[3]) / 4));
+        morph.processXY (0.2f, 0.9f, plain.data());
+        CHECK (plain[6] == voices.convertFrom0to1 (c[6]));
+
+        // weights don't need to add up to 1
+        const std::array<float, 4> weights { 0.0f, 2.0f, 0.0f, 6.0f };
+        morph.process (weights.data(), plain.data());
+        CHECK (morph.getNormalized()[1] == Catch::Approx (0.25f * b[1] + 0.75f * d[1]));
+        CHECK (plain[6] == voices.convertFrom0to1 (d[6]));
+
+        morph.setSnapshot (3, c.data());
+        morph.process (weights.data(), plain.data());
+        CHECK (morph.getNormalized()[1] == Catch::Approx (0.25f * b[1] + 0.75f * c[1]));
+    }
+
+    SECTION ("any range type, and snapshots from a bank")
+    {
+        melatonin::MorphEngine<melatonin::LogRange> release;
+        release.addParameters (melatonin::LogRange (0.0f, 15.0f), 3);
+
+        auto writer = melatonin::SnapshotWriter::create ({ "release1", "release2", "release3" });
+        REQUIRE (writer.has_value());
+        const std::array<float, 3> shortest { 0.0f, 0.0f, 0.0f }, longest { 1.0f, 1.0f, 1.0f };
+        writer->addPreset (shortest.data());
+        writer->addPreset (longest.data());
+        const auto block = writer->toMemoryBlock();
+        const melatonin::SnapshotView bank (block.getData(), block.getSize());
+        release.addSnapshot (bank, 0);
+        release.addSnapshot (bank, 1);
+
+        std::array<float, 3> seconds;
+        release.process (0.5f, seconds.data());
+        CHECK (seconds[2] == Catch::Approx (melatonin::LogRange (0.0f, 15.0f).convertFrom0to1 (0.5f)));
+
+        melatonin::MorphEngine<juce::NormalisableRange<float>> factories;
+        factories.addParameters (intRangeWithMidPoint (0, 10, 5));
+        factories.addParameters (linearRange (0.0f, 10.0f));
+        const std::array<float, 2> zero { 0.0f, 0.0f }, one { 1.0f, 1.0f };
+        factories.addSnapshot (zero.data());
+        factories.addSnapshot (one.data());
+        factories.process (0.3f, plain.data());
+        CHECK (plain[0] == 0.0f);
+        CHECK (plain[1] == Catch::Approx (3.0f));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters morph benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("morphing 800 parameters on an XY pad")
+    {
+        // 512 frequencies, 256 gains and 32 stepped parameters, between 4 corner presets
+        std::vector<juce::NormalisableRange<float>> ranges;
+        melatonin::MorphEngine<> morph;
+        morph.addParameters (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f), 512);
+        morph.addParameters (melatonin::CompactRange::decibels (-60.0f, 6.0f), 256);
+        morph.addParameters (melatonin::CompactRange::intWithMidPoint (1, 8, 4), 32);
+        for (size_t i = 0; i < 800; ++i)
+            ranges.push_back (i < 512 ? logarithmicRange (20.0f, 20000.0f, 10.0f) : i < 768 ? decibelRange (-60.0f, 6.0f) : intRangeWithMidPoint (1, 8, 4));
+
+        std::vector<std::vector<float>> corners;
+        for (size_t corner = 0; corner < 4; ++corner)
+        {
+            corners.emplace_back (normalized.begin() + (long) (corner * 50), normalized.begin() + (long) (corner * 50 + 800));
+            morph.addSnapshot (corners.back().data());
+        }
+
+        std::vector<float> values (800);
+        float x = 0.0f;
+        BENCHMARK ("per parameter, NormalisableRange")
+        {
+            x = x > 1.0f ? 0.0f : x + 0.001f;
+            const auto y = 1.0f - x;
+            const float weights[] = { (1.0f - x) * (1.0f - y), x * (1.0f - y), (1.0f - x) * y, x * y };
+            for (size_t i = 0; i < 800; ++i)
+            {
+                auto value = 0.0f;
+                for (size_t corner = 0; corner < 4; ++corner)
+                    value += corners[corner][i] * weights[corner];
+                values[i] = ranges[i].convertFrom0to1 (value);
+            }
+            return values[0];
+        };
+
+        BENCHMARK ("MorphEngine::processXY")
+        {
+            x = x > 1.0f ? 0.0f : x + 0.001f;
+            morph.processXY (x, 1.0f - x, values.data());
+            return values[0];
+        };
+    }
+}
+#endif
@@ -0,0 +1,206 @@
+#include <thread>
+
+TEST_CASE ("Melatonin Parameters parameter store")
+{
+    const auto frequency = melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f);
+    const auto gain = melatonin::CompactRange::decibels (-60.0f, 6.0f);
+
+    auto addLayout = [&] (melatonin::ParameterStore<>& store) {
+        CHECK (store.addParameters (frequency, 20) == 0);
+        CHECK (store.addParameters (gain, 20) == 20);
+        CHECK (store.getNumParameters() == 40);
+    };
+
+    SECTION ("the reader sees what's published, and only once it's published")
+    {
+        melatonin::ParameterStore<> store;
+        addLayout (store);
+        CHECK (store.read()[5] == 0.0f);
+        CHECK_FALSE (store.hasUpdate());
+
+        store.setNormalized (5, 0.5f);
+        CHECK (store.read()[5] == 0.0f);
+
+        store.publish();
+        CHECK (store.hasUpdate());
+        CHECK (store.read()[5] == 0.5f);
+        CHECK_FALSE (store.hasUpdate());
+        CHECK (store.read()[5] == 0.5f);
+    }
+
+    SECTION ("writes build on what was published")
+    {
+        melatonin::ParameterStore<> store;
+        addLayout (store);
+        store.setNormalized (0, 0.1f);
+        store.publish();
+        store.setNormalized (1, 0.2f);
+        store.publish();
+        store.setNormalized (2, 0.3f);
+        store.publish();
+        store.setNormalized (3, 0.4f);
+        store.publish();
+
+        const auto* values = store.read();
+        CHECK (values[0] == 0.1f);
+        CHECK (values[1] == 0.2f);
+        CHECK (values[2] == 0.3f);
+        CHECK (values[3] == 0.4f);
+        CHECK (store.getWriteBuffer()[3] == 0.4f);
+    }
+
+    SECTION ("a read stays the same while the writer keeps publishing")
+    {
+        melatonin::ParameterStore<> store;
+        addLayout (store);
+        store.setNormalized (0, 0.25f);
+        store.publish();
+        const auto* values = store.read();
+
+        for (auto value : { 0.5f, 0.75f, 1.0f })
+        {
+            store.setNormalized (0, value);
+            store.publish();
+            CHECK (values[0] == 0.25f);
+        }
+
+        CHECK (store.read()[0] == 1.0f);
+    }
+
+    SECTION ("plain values through the ranges")
+    {
+        melatonin::ParameterStore<> store;
+        addLayout (store);
+        std::vector<float> normalized (40);
+        for (size_t i = 0; i < normalized.size(); ++i)
+            normalized[i] = (float) i / 39.0f;
+        store.setNormalized (normalized.data());
+        store.publish();
+
+        std::vector<float> plain (40);
+        store.readPlainValues (plain.data());
+        for (size_t i = 0; i < 20; ++i)
+        {
+            CHECK (plain[i] == Catch::Approx (frequency.convertFrom0to1 (normalized[i])));
+            CHECK (store.getPlainValue ((int) i) == Catch::Approx (plain[i]));
+        }
+        for (size_t i = 20; i < 40; ++i)
+        {
+            CHECK (plain[i] == Catch::Approx (gain.convertFrom0to1 (normalized[i])).margin (1e-4));
+            CHECK (store.getPlainValue ((int) i) == Catch::Approx (plain[i]).margin (1e-4));
+        }
+    }
+
+    SECTION ("buffers start on their own cache line")
+    {
+        melatonin::ParameterStore<> store;
+        addLayout (store);
+        for (int i = 0; i < 3; ++i)
+        {
+            CHECK (reinterpret_cast<uintptr_t> (store.getWriteBuffer()) % 64 == 0u);
+            CHECK (reinterpret_cast<uintptr_t> (store.read()) % 64 == 0u);
+            store.publish();
+        }
+
+        melatonin::ParameterStore<melatonin::LogRange> single;
+        single.addParameters (melatonin::LogRange (0.0f, 15.0f));
+        CHECK (reinterpret_cast<uintptr_t> (single.getWriteBuffer()) % 64 == 0u);
+        CHECK (single.read() != single.getWriteBuffer());
+    }
+
+    SECTION ("every read is one whole publish, across threads")
+    {
+        melatonin::ParameterStore<> store;
+        addLayout (store);
+        constexpr int numPublishes = 200000;
+
+        // every publish sets all the values to the same number, so a torn read would show two different ones
+        std::thread writer ([&] {
+            for (int i = 1; i <= numPublishes; ++i)
+            {
+                auto* values = store.getWriteBuffer();
+                std::fill (values, values + store.getNumParameters(), (float) i);
+                store.publish();
+            }
+        });
+
+        int numTorn = 0, numBackwards = 0;
+        float last = 0.0f;
+        while (last < (float) numPublishes)
+        {
+            const auto* values = store.read();
+            if (std::any_of (values, values + store.getNumParameters(), [&] (float v) { return v != values[0]; }))
+                ++numTorn;
+            if (values[0] < last)
+                ++numBackwards;
+            last = values[0];
+        }
+        writer.join();
+
+        CHECK (numTorn == 0);
+        CHECK (numBackwards == 0);
+        CHECK (store.read()[39] == (float) numPublishes);
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters parameter store benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("reading 512 parameters each block")
+    {
+        // an atomic per parameter, each allocated on its own between other allocations, each with its own range
+        std::vector<std::unique_ptr<std::atomic<float>>> atomics;
+        std::vector<juce::NormalisableRange<float>> ranges;
+        std::vector<std::unique_ptr<std::string>> clutter;
+        for (size_t i = 0; i < 512; ++i)
+        {
+            ranges.push_back (i < 256 ? logarithmicRange (20.0f, 20000.0f, 10.0f) : decibelRange (-60.0f, 6.0f));
+            atomics.push_back (std::make_unique<std::atomic<float>> (normalized[i]));
+            clutter.push_back (std::make_unique<std::string> (64, 'x'));
+        }
+
+        melatonin::ParameterStore<> store;
+        store.addParameters (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f), 256);
+        store.addParameters (melatonin::CompactRange::decibels (-60.0f, 6.0f), 256);
+        store.setNormalized (normalized.data());
+        store.publish();
+
+        std::vector<float> values (512);
+        BENCHMARK ("512 std::atomic<float> loads")
+        {
+            for (size_t i = 0; i < 512; ++i)
+                values[i] = atomics[i]->load (std::memory_order_relaxed);
+            return values[0];
+        };
+
+        BENCHMARK ("ParameterStore::read, 512 normalized values")
+        {
+            const auto* latest = store.read();
+            std::copy (latest, latest + 512, values.data());
+            return values[0];
+        };
+
+        BENCHMARK ("512 std::atomic<float> loads, each through its range")
+        {
+            for (size_t i = 0; i < 512; ++i)
+                values[i] = ranges[i].convertFrom0to1 (atomics[i]->load (std::memory_order_relaxed));
+            return values[0];
+        };
+
+        BENCHMARK ("ParameterStore::readPlainValues")
+        {
+            store.readPlainValues (values.data());
+            return values[0];
+        };
+
+        BENCHMARK ("ParameterStore::publish")
+        {
+            store.setNormalized (7, values[0] * 0.0f);
+            store.publish();
+            return store.hasUpdate();
+        };
+    }
+}
+#endif
@@ -0,0 +1,259 @@
+TEST_CASE ("Melatonin Parameters parsers")
+{
+    // What the *FromString lambdas did before they went through the parsers
+    auto timeReference = [] (const juce::String& text) {
+        if (text.endsWith ("ms"))
+            return text.dropLastCharacters (2).getFloatValue() / 1000.0f;
+        else if (text.endsWith ("s"))
+            return text.dropLastCharacters (1).getFloatValue();
+        else if (text.contains ("."))
+            return text.getFloatValue();
+        return text.getFloatValue() / 1000.0f;
+    };
+
+    auto percentReference = [] (const juce::String& text) {
+        if (text.toLowerCase() == "off")
+            return 0.0f;
+        else if (text.endsWith ("%"))
+            return text.dropLastCharacters (1).getFloatValue() / 100.0f;
+        return text.getFloatValue() / 100.0f;
+    };
+
+    auto hzReference = [] (const juce::String& text) {
+        if (text.toLowerCase().endsWith ("khz"))
+            return text.dropLastCharacters (3).getFloatValue() * 1000.0f;
+        if (text.toLowerCase().endsWith ("hz"))
+            return text.dropLastCharacters (2).getFloatValue();
+        return text.getFloatValue();
+    };
+
+    auto dBReference = [] (const juce::String& text) {
+        if (text.toLowerCase() == "off")
+            return -64.0f;
+        if (text.endsWith ("db"))
+            return text.dropLastCharacters (2).getFloatValue();
+        return text.getFloatValue();
+    };
+
+    SECTION ("match the original juce::String code")
+    {
+        for (auto number : { "0", "1", "10", "100", "1000", "-3", "-3.1", "-3.12", ".1", "0.1", "1.", "1.0", "15.98", "+2.5", " 42", "\t7.5", "1e3", "abc", "", "-", "." })
+        {
+            for (auto suffix : { "", "ms", "s", "db", "%", "hz", "Hz", "kHz", " Hz", " kHz", "junk" })
+            {
+                auto text = juce::String (number) + suffix;
+                CHECK (timeValueFromString (text) == timeReference (text));
+                CHECK (percentValueFromString (text) == percentReference (text));
+                CHECK (hzValueFromString (text) == hzReference (text));
+                CHECK (dBFromStringWithOffAt64 (text) == dBReference (text));
+                CHECK (dBFromString (text) == (text.endsWith ("db") ? text.dropLastCharacters (2).getFloatValue() : text.getFloatValue()));
+                CHECK (zeroTo1FromString (text) == text.getFloatValue());
+                CHECK (intValueFromString (text) == (float) text.getIntValue());
+                CHECK (semiValueFromString (text) == (float) text.getIntValue());
+            }
+        }
+
+        for (auto text : { "off", "OFF", "Off" })
+        {
+            CHECK (percentValueFromString (text) == 0.0f);
+            CHECK (dBFromStringWithOffAt64 (text) == -64.0f);
+        }
+    }
+
+    SECTION ("no decimal and no unit still means ms")
+    {
+        CHECK (melatonin::parsers::timeValue ("250") == Catch::Approx (0.25f));
+        CHECK (melatonin::parsers::timeValue ("2.5") == Catch::Approx (2.5f));
+        CHECK (melatonin::parsers::timeValue ("2") == Catch::Approx (0.002f));
+    }
+
+    SECTION ("units match regardless of case")
+    {
+        CHECK (melatonin::parsers::timeValue ("1.5MS") == Catch::Approx (0.0015f));
+        CHECK (melatonin::parsers::timeValue ("1.5S") == Catch::Approx (1.5f));
+        CHECK (melatonin::parsers::dB ("-6dB") == Catch::Approx (-6.0f));
+        CHECK (melatonin::parsers::hzValue ("1.5KHZ") == Catch::Approx (1500.0f));
+    }
+
+    SECTION ("works on views into a bigger buffer")
+    {
+        std::string_view line = "250ms,-6.0db,1.5 kHz";
+        CHECK (melatonin::parsers::timeValue (line.substr (0, 5)) == Catch::Approx (0.25f));
+        CHECK (melatonin::parsers::dB (line.substr (6, 6)) == Catch::Approx (-6.0f));
+        CHECK (melatonin::parsers::hzValue (line.substr (13)) == Catch::Approx (1500.0f));
+
+        // only the view is read, not what comes after it
+        CHECK (melatonin::parsers::getFloatValue (line.substr (0, 2)) == 25.0f);
+        CHECK (melatonin::parsers::getIntValue (line.substr (0, 1)) == 2);
+    }
+
+    SECTION ("parse straight to double")
+    {
+        CHECK (melatonin::parsers::getFloatValue<double> ("0.1") == 0.1);
+        CHECK (melatonin::parsers::timeValue<double> ("15.98s") == 15.98);
+        CHECK (melatonin::parsers::timeValue<double> ("11.1ms") == 11.1 / 1000);
+        CHECK (melatonin::parsers::hzValue<double> ("1.234567 kHz") == Catch::Approx (1234.567).epsilon (1e-12));
+        CHECK (melatonin::parsers::dBWithOffAt64<double> ("off") == -64.0);
+        CHECK (melatonin::parsers::percentValue<double> ("33.3%") == 33.3 / 100);
+        CHECK (melatonin::parsers::semiValue<double> ("-7 semi") == -7.0);
+    }
+
+    SECTION ("the fallback for standard libraries without from_chars reads the same numbers")
+    {
+        using melatonin::parsers::readDecimal;
+
+        // it never asks the C library, so it doesn't matter what the locale's decimal point is
+        for (auto text : { "0", "1", "-3", "-3.1", ".1", "0.1", "1.", "15.98", "0.000123", "1234.5678", "20000", "-60", "1e3", "2.5E-1", "7e+2",
+                 "3.14159265", "0.1ms", "12 dB", "1e", "1e-", "5e+x", "-0", "1.7976931348623157e308", "2.2250738585072014e-308" })
+        {
+            CHECK (readDecimal (text) == melatonin::parsers::getFloatValue<double> (text));
+        }
+
+        // past 15 or so digits (or 10^22), it's still within an ulp or so
+        for (auto text : { "123456789012345678901234567890", "0.1234567890123456789", "6.02214076e23", "1.602176634e-19", "9007199254740993" })
+            CHECK (readDecimal (text) == Catch::Approx (melatonin::parsers::getFloatValue<double> (text)).epsilon (1e-15));
+
+        CHECK (readDecimal ("1e400") == std::numeric_limits<double>::infinity());
+        CHECK (readDecimal ("-1e400") == -std::numeric_limits<double>::infinity());
+        CHECK (readDecimal ("1e-400") == 0.0);
+        CHECK (readDecimal ("-INF") == -std::numeric_limits<double>::infinity());
+        CHECK (std::isnan (readDecimal ("nan")));
+        CHECK (readDecimal ("abc") == 0.0);
+        CHECK (readDecimal (".") == 0.0);
+        CHECK (readDecimal ("-") == 0.0);
+    }
+
+    SECTION ("strict parsing agrees with the lambdas on good text")
+    {
+        using namespace melatonin::parsers;
+
+        // every combination either parses to the same value as the lambda, or is rejected
+        for (auto number : { "0", "1", "10", "100", "1000", "-3", "-3.1", "-3.12", ".1", "0.1", "1.", "1.0", "15.98", "+2.5", " 42", "\t7.5", "1e3", "2.5E-1" })
+        {
+            for (auto suffix : { "", "ms", "s", "db", "dB", "%", "hz", "Hz", "kHz", " Hz", " kHz", "junk" })
+            {
+                auto text = juce::String (number) + suffix;
+                auto view = toStringView (text);
+
+                auto checkAgrees = [&] (auto result, float lenient) {
+                    if (result)
+                        CHECK (result.value == lenient);
+                };
+
+                checkAgrees (melatonin::parse<Time> (view), timeValueFromString (text));
+                checkAgrees (melatonin::parse<Decibels> (view), dBFromString (text));
+                checkAgrees (melatonin::parse<DecibelsWithOffAt64> (view), dBFromStringWithOffAt64 (text));
+                checkAgrees (melatonin::parse<Hz> (view), hzValueFromString (text));
+                checkAgrees (melatonin::parse<Percent> (view), percentValueFromString (text));
+                checkAgrees (melatonin::parse<ZeroTo1> (view), zeroTo1FromString (text));
+
+                // only junk is unknown, the rest is a unit one parameter or another takes
+                CHECK ((tokenize (view).error == ParseError::unknownUnit) == (juce::String (suffix) == "junk"));
+            }
+        }
+
+        CHECK (melatonin::parse<Time> ("250").value == Catch::Approx (0.25f));
+        CHECK (melatonin::parse<Time> ("2.5").value == Catch::Approx (2.5f));
+        CHECK (melatonin::parse<Time> ("11.1 MS").value == Catch::Approx (0.0111f));
+        CHECK (melatonin::parse<Percent> ("off").value == 0.0f);
+        CHECK (melatonin::parse<DecibelsWithOffAt64> ("OFF").value == -64.0f);
+        CHECK (melatonin::parse<Int> ("42").value == 42.0f);
+        CHECK (melatonin::parse<Int> ("-3.9").value == (float) juce::String ("-3.9").getIntValue());
+        CHECK (melatonin::parse<Semi> ("-7 semi").value == -7.0f);
+        CHECK (melatonin::parse<Semi, double> ("12").value == 12.0);
+        CHECK (melatonin::parse<Time, double> ("15.98s").value == 15.98);
+    }
+
+    SECTION ("strict parsing takes other ways of writing a unit")
+    {
+        using namespace melatonin::parsers;
+        CHECK (melatonin::parse<Hz> ("1.2k").value == Catch::Approx (1200.0f));
+        CHECK (melatonin::parse<Hz> ("1.2 K").value == Catch::Approx (1200.0f));
+        CHECK (melatonin::parse<Hz> ("20khz").value == Catch::Approx (20000.0f));
+        CHECK (melatonin::parse<Decibels> ("-inf").value == -std::numeric_limits<float>::infinity());
+        CHECK (melatonin::parse<Decibels> ("-INF dB").value == -std::numeric_limits<float>::infinity());
+        CHECK (melatonin::parse<Decibels> (" -6 dB ").value == -6.0f);
+        CHECK (melatonin::parse<Decibels> ("1e-400").value == 0.0f);
+
+        // the lambda only looks for a unit at the very end, so it reads this one as 2.5 seconds
+        CHECK (melatonin::parse<Time> ("2.5 ms ").value == Catch::Approx (0.0025f));
+    }
+
+    SECTION ("strict parsing rejects bad text")
+    {
+        using namespace melatonin::parsers;
+        CHECK (melatonin::parse<Time> ("").error == ParseError::empty);
+        CHECK (melatonin::parse<Time> ("  ").error == ParseError::empty);
+        CHECK (melatonin::parse<Time> ("abc").error == ParseError::noNumber);
+        CHECK (melatonin::parse<Time> ("-").error == ParseError::noNumber);
+        CHECK (melatonin::parse<Time> (".").error == ParseError::noNumber);
+        CHECK (melatonin::parse<Time> ("ms").error == ParseError::noNumber);
+        CHECK (melatonin::parse<Time> ("12 parsecs").error == ParseError::unknownUnit);
+        CHECK (melatonin::parse<Time> ("1.2.3").error == ParseError::unknownUnit);
+        CHECK (melatonin::parse<Time> ("10 off").error == ParseError::unknownUnit);
+        CHECK (melatonin::parse<Time> ("10 Hz").error == ParseError::wrongUnit);
+        CHECK (melatonin::parse<Hz> ("10ms").error == ParseError::wrongUnit);
+        CHECK (melatonin::parse<Decibels> ("off").error == ParseError::wrongUnit);
+        CHECK (melatonin::parse<Int> ("5%").error == ParseError::wrongUnit);
+        CHECK (melatonin::parse<Time> ("-inf").error == ParseError::notFinite);
+        CHECK (melatonin::parse<Percent> ("inf%").error == ParseError::notFinite);
+
+        // only -inf is a level
+        CHECK (melatonin::parse<Decibels> ("inf").error == ParseError::notFinite);
+        CHECK (melatonin::parse<Decibels> ("+inf").error == ParseError::notFinite);
+        CHECK (melatonin::parse<Decibels> ("+inf dB").error == ParseError::notFinite);
+        CHECK (melatonin::parse<DecibelsWithOffAt64> ("INF").error == ParseError::notFinite);
+        CHECK (melatonin::parse<Decibels> ("1e400").error == ParseError::notFinite);
+        CHECK (melatonin::parse<Decibels> ("1e39 dB").error == ParseError::notFinite);
+        CHECK (melatonin::parse<Decibels, double> ("1e39 dB").value == 1e39);
+        CHECK (melatonin::parse<Decibels> ("-1e400").error == ParseError::notFinite);
+
+        // getIntValue stops at the e, so the lenient versions read 1
+        CHECK (intValueFromString ("1e3") == 1.0f);
+        CHECK (semiValueFromString ("1e3") == 1.0f);
+        CHECK (melatonin::parse<Int> ("1e3").error == ParseError::exponent);
+        CHECK (melatonin::parse<Semi> ("1e3 semi").error == ParseError::exponent);
+        CHECK (melatonin::parse<Semi> ("2.5E-1").error == ParseError::exponent);
+
+        // nothing went wrong in the lenient version, it just made something up
+        CHECK (timeValueFromString ("abc") == 0.0f);
+        CHECK_FALSE (melatonin::parse<Time> ("abc"));
+        CHECK (melatonin::parse<Time> ("abc").valueOr (0.1f) == 0.1f);
+        CHECK (melatonin::parse<Time> ("100ms"));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters parser benchmarks", "[!benchmark]")
+{
+    SECTION ("from a string_view")
+    {
+        const std::vector<std::string_view> texts { "0ms", "11.1ms", "100ms", "1.0s", "15.98s", "3.5", "250" };
+        size_t i = 0;
+        BENCHMARK ("melatonin::parsers::timeValue")
+        {
+            return melatonin::parsers::timeValue (texts[i++ % texts.size()]);
+        };
+
+        CHECK (melatonin::allocations::perCall ([&] (int n) { return melatonin::parsers::timeValue (texts[(size_t) n % texts.size()]); }) == 0);
+
+        BENCHMARK ("melatonin::parse<Time>")
+        {
+            return melatonin::parse<melatonin::parsers::Time> (texts[i++ % texts.size()]).value;
+        };
+
+        CHECK (melatonin::allocations::perCall ([&] (int n) { return melatonin::parse<melatonin::parsers::Time> (texts[(size_t) n % texts.size()]).value; }) == 0);
+
+        const std::vector<std::string_view> frequencies { "20 Hz", "440hz", "1.2k", "1.5 kHz", "20000", "abc" };
+        BENCHMARK ("melatonin::parsers::hzValue")
+        {
+            return melatonin::parsers::hzValue (frequencies[i++ % frequencies.size()]);
+        };
+
+        BENCHMARK ("melatonin::parse<Hz>")
+        {
+            return melatonin::parse<melatonin::parsers::Hz> (frequencies[i++ % frequencies.size()]).value;
+        };
+    }
+}
+#endif
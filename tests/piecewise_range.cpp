@@ -0,0 +1,127 @@
+TEST_CASE ("Melatonin Parameters piecewise range")
+{
+    SECTION ("two segments are logarithmicRangeWithLinearStart")
+    {
+        auto factory = logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000);
+        auto range = melatonin::PiecewiseRange<>::logWithLinearStart (0.0f, 10000.0f, 6.0f, 1000);
+        CHECK (range.getNumSegments() == 2u);
+
+        for (int i = 0; i <= 1000; ++i)
+        {
+            auto normalized = (float) i / 1000.0f;
+            auto unnormalized = factory.convertFrom0to1 (normalized);
+            CHECK (range.convertFrom0to1 (normalized) == Catch::Approx (unnormalized).margin (1e-3));
+            CHECK (range.convertTo0to1 (unnormalized) == Catch::Approx (factory.convertTo0to1 (unnormalized)).margin (1e-6));
+        }
+    }
+
+    SECTION ("one segment is logarithmicRange or linearRange")
+    {
+        auto log = melatonin::PiecewiseRange<1> ({ { 0.0f, 20.0f }, { 1.0f, 20000.0f, 10.0f } });
+        auto linear = melatonin::PiecewiseRange<1> ({ { 0.0f, -1.0f }, { 1.0f, 1.0f } });
+        auto logFactory = logarithmicRange (20.0f, 20000.0f, 10.0f);
+        auto linearFactory = linearRange (-1.0f, 1.0f);
+
+        for (int i = 0; i <= 100; ++i)
+        {
+            auto normalized = (float) i / 100.0f;
+            CHECK (log.convertFrom0to1 (normalized) == Catch::Approx (logFactory.convertFrom0to1 (normalized)).epsilon (1e-5));
+            CHECK (log.convertTo0to1 (logFactory.convertFrom0to1 (normalized)) == Catch::Approx (normalized).margin (1e-5));
+            CHECK (linear.convertFrom0to1 (normalized) == Catch::Approx (linearFactory.convertFrom0to1 (normalized)).margin (1e-6));
+            CHECK (linear.convertTo0to1 (linearFactory.convertFrom0to1 (normalized)) == Catch::Approx (normalized).margin (1e-6));
+        }
+    }
+
+    // detail around 80Hz and 1kHz, with a concave top end
+    auto frequency = melatonin::PiecewiseRange<> ({ { 0.0f, 20.0f }, { 0.3f, 120.0f, 3.0f }, { 0.4f, 200.0f }, { 0.7f, 1500.0f, 3.0f }, { 1.0f, 20000.0f, -2.0f } });
+
+    SECTION ("hits every breakpoint and round trips")
+    {
+        CHECK (frequency.getNumSegments() == 4u);
+        CHECK (frequency.getStart() == 20.0f);
+        CHECK (frequency.getEnd() == 20000.0f);
+
+        for (auto [normalized, unnormalized] : { std::pair (0.0f, 20.0f), std::pair (0.3f, 120.0f), std::pair (0.4f, 200.0f), std::pair (0.7f, 1500.0f), std::pair (1.0f, 20000.0f) })
+        {
+            CHECK (frequency.convertFrom0to1 (normalized) == Catch::Approx (unnormalized).epsilon (1e-5));
+            CHECK (frequency.convertTo0to1 (unnormalized) == Catch::Approx (normalized).margin (1e-6));
+        }
+
+        float previous = 0.0f;
+        for (int i = 0; i <= 1000; ++i)
+        {
+            auto normalized = (float) i / 1000.0f;
+            auto unnormalized = frequency.convertFrom0to1 (normalized);
+            CHECK (unnormalized >= previous);
+            CHECK (frequency.convertTo0to1 (unnormalized) == Catch::Approx (normalized).margin (1e-5));
+            previous = unnormalized;
+        }
+
+        // the concave segment rises fastest at its start
+        CHECK (frequency.convertFrom0to1 (0.85f) > (1500.0f + 20000.0f) / 2);
+    }
+
+    SECTION ("clamps like the other ranges")
+    {
+        CHECK (frequency.convertFrom0to1 (-1.0f) == 20.0f);
+        CHECK (frequency.convertFrom0to1 (2.0f) == Catch::Approx (20000.0f));
+        CHECK (frequency.convertTo0to1 (0.0f) == 0.0f);
+        CHECK (frequency.convertTo0to1 (1.0e6f) == 1.0f);
+    }
+
+    SECTION ("block conversions match the scalar ones")
+    {
+        for (auto accuracy : { melatonin::Accuracy::exact, melatonin::Accuracy::fast, melatonin::Accuracy::fastest })
+        {
+            auto range = melatonin::PiecewiseRange<> ({ { 0.0f, 20.0f }, { 0.3f, 120.0f, 3.0f }, { 0.4f, 200.0f }, { 0.7f, 1500.0f, 3.0f }, { 1.0f, 20000.0f, -2.0f } }, accuracy);
+
+            // more than one internal block, and a few outside 0-1
+            std::vector<float> normalized, unnormalized (300), roundTrip (300);
+            for (int i = 0; i < 300; ++i)
+                normalized.push_back ((float) i / 280.0f - 0.02f);
+
+            range.convertFrom0to1 (normalized.data(), unnormalized.data(), (int) normalized.size());
+            range.convertTo0to1 (unnormalized.data(), roundTrip.data(), (int) unnormalized.size());
+            for (size_t i = 0; i < normalized.size(); ++i)
+            {
+                CHECK (unnormalized[i] == Catch::Approx (range.convertFrom0to1 (normalized[i])).epsilon (1e-6));
+                CHECK (roundTrip[i] == Catch::Approx (range.convertTo0to1 (unnormalized[i])).margin (1e-6));
+            }
+        }
+    }
+
+    SECTION ("converts to a NormalisableRange")
+    {
+        juce::NormalisableRange<float> converted = frequency;
+        CHECK (converted.start == 20.0f);
+        CHECK (converted.end == 20000.0f);
+        CHECK (converted.convertFrom0to1 (0.3f) == Catch::Approx (120.0f));
+        CHECK (melatonin::hasBlockConversion<melatonin::PiecewiseRange<>>::value);
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters piecewise range benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("piecewise ranges")
+    {
+        melatonin::benchmarks::benchmarkRange ("PiecewiseRange (2 segments)", melatonin::PiecewiseRange<>::logWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f));
+
+        const auto frequency = melatonin::PiecewiseRange<> ({ { 0.0f, 20.0f }, { 0.3f, 120.0f, 3.0f }, { 0.4f, 200.0f }, { 0.7f, 1500.0f, 3.0f }, { 1.0f, 20000.0f, -2.0f } });
+        size_t i = 0;
+        BENCHMARK ("PiecewiseRange (4 segments) convertFrom0to1 without std::function")
+        {
+            return frequency.convertFrom0to1 (normalized[i++ & 1023]);
+        };
+
+        std::vector<float> results (512);
+        BENCHMARK ("PiecewiseRange (4 segments) block of 512")
+        {
+            frequency.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+    }
+}
+#endif
@@ -0,0 +1,137 @@
+TEST_CASE ("Melatonin Parameters range registry")
+{
+    melatonin::RangeRegistry registry;
+
+    SECTION ("the same range is shared")
+    {
+        auto band1 = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+        auto band2 = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+        auto gain = registry.intern (melatonin::CompactRange::decibels (-60.0f, 6.0f));
+
+        CHECK (band1 == band2);
+        CHECK (band1 != gain);
+        CHECK (registry.getNumUniqueRanges() == 2u);
+
+        // and converts like the range it was made from
+        CHECK (band1->convertFrom0to1 (0.5f) == Catch::Approx (melatonin::LogRange (20.0f, 20000.0f, 10.0f).convertFrom0to1 (0.5f)));
+    }
+
+    SECTION ("any difference is a different range")
+    {
+        auto exact = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+        auto fast = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f, melatonin::Accuracy::fast));
+        auto steeper = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 11.0f));
+        auto linear = registry.intern (melatonin::CompactRange::linear (20.0f, 20000.0f));
+
+        CHECK (exact != fast);
+        CHECK (exact != steeper);
+        CHECK (exact != linear);
+        CHECK (registry.getNumUniqueRanges() == 4u);
+    }
+
+    SECTION ("ranges go away with their last handle")
+    {
+        auto kept = registry.intern (melatonin::CompactRange::intWithMidPoint (0, 100, 80));
+        {
+            auto temporary = registry.intern (melatonin::CompactRange::decibelsForHarmonic (3));
+            auto again = registry.intern (melatonin::CompactRange::decibelsForHarmonic (3));
+            CHECK (registry.getNumUniqueRanges() == 2u);
+        }
+        CHECK (registry.getNumUniqueRanges() == 1u);
+
+        // interning it again builds a new one
+        auto rebuilt = registry.intern (melatonin::CompactRange::decibelsForHarmonic (3));
+        CHECK (rebuilt->end == Catch::Approx (decibelRangeForHarmonic (3).end));
+        CHECK (registry.getNumUniqueRanges() == 2u);
+    }
+
+    SECTION ("instances loading on different threads share too")
+    {
+        std::vector<std::vector<melatonin::RangeRegistry::Handle>> handles (4);
+        std::vector<std::thread> threads;
+        for (auto& threadHandles : handles)
+        {
+            threads.emplace_back ([&registry, &threadHandles] {
+                for (int i = 0; i < 1000; ++i)
+                    threadHandles.push_back (registry.intern (melatonin::CompactRange::log (0.0f, (float) (i % 10 + 1))));
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK (registry.getNumUniqueRanges() == 10u);
+        for (auto& threadHandles : handles)
+            for (size_t i = 0; i < threadHandles.size(); ++i)
+                CHECK (threadHandles[i] == handles[0][i]);
+    }
+
+    SECTION ("parameters copy the shared range")
+    {
+        // what AudioParameterFloat does with *handle: every band of every instance keeps its own copy of the NormalisableRange,
+        // which only holds inline constants (see toNormalisableRange), so there's nothing on the heap to duplicate
+        std::vector<juce::NormalisableRange<float>> parameters;
+        for (int band = 0; band < 64; ++band)
+        {
+            auto frequency = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+            auto gain = registry.intern (melatonin::CompactRange::decibels (-60.0f, 6.0f));
+            parameters.push_back (*frequency);
+            parameters.push_back (*gain);
+        }
+
+        CHECK (registry.getNumUniqueRanges() == 0u);
+
+        const auto frequency = melatonin::LogRange (20.0f, 20000.0f, 10.0f);
+        for (size_t i = 0; i < parameters.size(); i += 2)
+        {
+            CHECK (parameters[i].convertFrom0to1 (0.5f) == frequency.convertFrom0to1 (0.5f));
+            CHECK (parameters[i + 1].convertFrom0to1 (0.5f) == Catch::Approx (-27.0f));
+        }
+    }
+
+    SECTION ("1000 parameters sharing a range only allocate for the first")
+    {
+        // the APVTS path: interning once per parameter, then copying the range into the parameter like AudioParameterFloat does
+        std::vector<melatonin::RangeRegistry::Handle> handles;
+        std::vector<juce::NormalisableRange<float>> parameters;
+        handles.reserve (1000);
+        parameters.reserve (1000);
+
+        const auto allocationsBefore = melatonin::allocations::count;
+        const auto bytesBefore = melatonin::allocations::bytes;
+        for (int i = 0; i < 1000; ++i)
+        {
+            handles.push_back (registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f)));
+            parameters.push_back (*handles.back());
+        }
+        const auto allocations = melatonin::allocations::count - allocationsBefore;
+
+        WARN ("1000 parameters sharing an interned range: " << allocations << " allocations, " << melatonin::allocations::bytes - bytesBefore << " bytes");
+        CHECK (registry.getNumUniqueRanges() == 1u);
+
+        // only the first intern builds anything, the copies into the parameters are free
+        CHECK (allocations <= 3u);
+    }
+
+    SECTION ("there's one for the whole process")
+    {
+        CHECK (&melatonin::RangeRegistry::getInstance() == &melatonin::RangeRegistry::getInstance());
+        auto handle = melatonin::RangeRegistry::getInstance().intern (melatonin::CompactRange::linear (0.0f, 1.0f));
+        CHECK (handle == melatonin::RangeRegistry::getInstance().intern (melatonin::CompactRange::linear (0.0f, 1.0f)));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters range registry benchmarks", "[!benchmark]")
+{
+    SECTION ("interning a range that's already registered")
+    {
+        melatonin::RangeRegistry registry;
+        auto kept = registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+        BENCHMARK ("interning a range that's already registered")
+        {
+            return registry.intern (melatonin::CompactRange::log (20.0f, 20000.0f, 10.0f));
+        };
+    }
+}
+#endif
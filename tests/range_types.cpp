@@ -0,0 +1,384 @@
+TEST_CASE ("Melatonin Parameters range types")
+{
+    // each type should be interchangeable with the factory it replaces
+    auto checkAgainst = [] (const juce::NormalisableRange<float>& factoryRange, const auto& rangeType) {
+        for (int i = 0; i <= 100; ++i)
+        {
+            auto normalized = (float) i / 100.0f;
+            auto unnormalized = factoryRange.convertFrom0to1 (normalized);
+            CHECK (rangeType.convertFrom0to1 (normalized) == Catch::Approx (unnormalized).margin (1e-6));
+            CHECK (rangeType.convertTo0to1 (unnormalized) == Catch::Approx (factoryRange.convertTo0to1 (unnormalized)).margin (1e-6));
+        }
+
+        // a block at a time converts the same as one value at a time (101 values, so there's a leftover after the SIMD lanes)
+        std::vector<float> normalized (101), unnormalized (101), blockUnnormalized (101), blockNormalized (101);
+        for (size_t i = 0; i < normalized.size(); ++i)
+        {
+            normalized[i] = (float) i / 100.0f;
+            unnormalized[i] = factoryRange.convertFrom0to1 (normalized[i]);
+        }
+        rangeType.convertFrom0to1 (normalized.data(), blockUnnormalized.data(), 101);
+        rangeType.convertTo0to1 (unnormalized.data(), blockNormalized.data(), 101);
+        for (size_t i = 0; i < normalized.size(); ++i)
+        {
+            CHECK (blockUnnormalized[i] == Catch::Approx (rangeType.convertFrom0to1 (normalized[i])));
+            CHECK (blockNormalized[i] == Catch::Approx (rangeType.convertTo0to1 (unnormalized[i])).margin (1e-6));
+        }
+
+        // and stay the same once handed to the APVTS as a NormalisableRange
+        juce::NormalisableRange<float> converted = rangeType;
+        CHECK (converted.start == factoryRange.start);
+        CHECK (converted.end == Catch::Approx (factoryRange.end));
+        CHECK (converted.convertFrom0to1 (0.3f) == Catch::Approx (factoryRange.convertFrom0to1 (0.3f)));
+        CHECK (converted.convertTo0to1 (factoryRange.convertFrom0to1 (0.7f)) == Catch::Approx (0.7f));
+    };
+
+    SECTION ("LinearRange")
+    {
+        checkAgainst (linearRange (-1.0f, 1.0f), melatonin::LinearRange (-1.0f, 1.0f));
+    }
+
+    SECTION ("LogRange")
+    {
+        checkAgainst (logarithmicRange (0.0f, 1.0f), melatonin::LogRange (0.0f, 1.0f));
+        checkAgainst (logarithmicRange (0.0f, 44100.0f, 10.0f), melatonin::LogRange (0.0f, 44100.0f, 10.0f));
+        checkAgainst (logarithmicRange (20.0f, 20000.0f, 10.0f), melatonin::LogRange (20.0f, 20000.0f, 10.0f));
+    }
+
+    SECTION ("LogRangeWithLinearStart")
+    {
+        checkAgainst (logarithmicRangeWithLinearStart (0.0f, 1.0f, 6.0f, 0.25f, 0.25f), melatonin::LogRangeWithLinearStart (0.0f, 1.0f, 6.0f, 0.25f, 0.25f));
+        checkAgainst (logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000), melatonin::LogRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000));
+
+        // the fast tiers pick a segment per SIMD lane, which has to agree with the branch, right up to the breakpoint
+        for (auto accuracy : { melatonin::Accuracy::fast, melatonin::Accuracy::fastest })
+        {
+            const auto range = melatonin::LogRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000, 0.25f, accuracy);
+            const std::vector<float> normalized { -0.5f, 0.0f, 0.1f, 0.2499f, 0.25f, 0.2501f, 0.5f, 1.0f, 1.5f };
+            const std::vector<float> unnormalized { -100.0f, 0.0f, 500.0f, 999.9f, 1000.0f, 1000.1f, 5000.0f, 10000.0f, 20000.0f };
+            std::vector<float> blockUnnormalized (normalized.size()), blockNormalized (unnormalized.size());
+            range.convertFrom0to1 (normalized.data(), blockUnnormalized.data(), (int) normalized.size());
+            range.convertTo0to1 (unnormalized.data(), blockNormalized.data(), (int) unnormalized.size());
+            for (size_t i = 0; i < normalized.size(); ++i)
+            {
+                CHECK (blockUnnormalized[i] == Catch::Approx (range.convertFrom0to1 (normalized[i])));
+                CHECK (blockNormalized[i] == Catch::Approx (range.convertTo0to1 (unnormalized[i])).margin (1e-6));
+            }
+        }
+    }
+
+    SECTION ("DecibelRange")
+    {
+        checkAgainst (decibelRange (-30.0f, 0.0f), melatonin::DecibelRange (-30.0f, 0.0f));
+        checkAgainst (decibelRange (-3.0f, 3.0f), melatonin::DecibelRange (-3.0f, 3.0f));
+
+        // decibelRange used to go through pow and log in both directions
+        auto powAndLogFrom0to1 = [] (float min, float max, float normalized) {
+            auto minAmp = std::pow (10.0f, min / 20.0f);
+            auto maxAmp = std::pow (10.0f, max / 20.0f);
+            return 20.0f * std::log10 (minAmp * std::pow (maxAmp / minAmp, normalized));
+        };
+
+        auto powAndLogTo0to1 = [] (float min, float max, float dB) {
+            auto minAmp = std::pow (10.0f, min / 20.0f);
+            auto maxAmp = std::pow (10.0f, max / 20.0f);
+            return std::log (std::pow (10.0f, dB / 20.0f) / minAmp) / std::log (maxAmp / minAmp);
+        };
+
+        for (auto [min, max] : { std::pair (-30.0f, 0.0f), std::pair (-3.0f, 3.0f), std::pair (-100.0f, 12.0f) })
+        {
+            auto factory = decibelRange (min, max);
+            auto type = melatonin::DecibelRange (min, max);
+            for (int i = 0; i <= 1000; ++i)
+            {
+                auto normalized = (float) i / 1000.0f;
+                auto dB = powAndLogFrom0to1 (min, max, normalized);
+                CHECK (factory.convertFrom0to1 (normalized) == Catch::Approx (dB).margin (1e-4));
+                CHECK (type.convertFrom0to1 (normalized) == Catch::Approx (dB).margin (1e-4));
+                CHECK (factory.convertTo0to1 (dB) == Catch::Approx (powAndLogTo0to1 (min, max, dB)).margin (1e-5));
+                CHECK (type.convertTo0to1 (dB) == Catch::Approx (powAndLogTo0to1 (min, max, dB)).margin (1e-5));
+
+                // and straight to gain
+                CHECK (type.gainFrom0to1 (normalized) == Catch::Approx (juce::Decibels::decibelsToGain (dB, min - 1.0f)).epsilon (1e-5));
+            }
+        }
+
+        auto range = melatonin::DecibelRange (-60.0f, 6.0f, melatonin::Accuracy::fast);
+        std::vector<float> values, gains (100);
+        for (int i = 0; i < 100; ++i)
+            values.push_back ((float) i / 99.0f);
+        range.gainFrom0to1 (values.data(), gains.data(), (int) values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            CHECK (gains[i] == Catch::Approx (juce::Decibels::decibelsToGain (range.convertFrom0to1 (values[i]))).epsilon (1e-5));
+    }
+
+    SECTION ("HarmonicDecibelRange")
+    {
+        checkAgainst (decibelRange(), melatonin::HarmonicDecibelRange (1));
+        checkAgainst (decibelRangeForHarmonic (3), melatonin::HarmonicDecibelRange (3));
+        checkAgainst (decibelRangeForHarmonic (10, -60.0f), melatonin::HarmonicDecibelRange (10, -60.0f));
+    }
+
+    SECTION ("IntRangeWithMidPoint")
+    {
+        checkAgainst (intRangeWithMidPoint (0, 100, 80), melatonin::IntRangeWithMidPoint (0, 100, 80));
+
+        juce::NormalisableRange<float> converted = melatonin::IntRangeWithMidPoint (0, 100, 80);
+        CHECK (converted.interval == 1.0f);
+        CHECK (converted.snapToLegalValue (16.4f) == 16.0f);
+    }
+
+    SECTION ("Reversed")
+    {
+        checkAgainst (reversedLogarithmicRange (0.0f, 15.0f), melatonin::reversed (melatonin::LogRange (0.0f, 15.0f)));
+        checkAgainst (reversedLogarithmicRange (20.0f, 20000.0f, 10.0f), melatonin::reversed (melatonin::LogRange (20.0f, 20000.0f, 10.0f)));
+
+        // any range type flips the same way, one value or a block at a time
+        auto checkReversed = [] (const auto& range) {
+            const auto reversed = melatonin::reversed (range);
+            CHECK (reversed.getStart() == range.getStart());
+            CHECK (reversed.getEnd() == range.getEnd());
+
+            std::vector<float> normalized, unnormalized;
+            for (int i = -10; i <= 110; ++i)
+            {
+                normalized.push_back ((float) i / 100.0f);
+                unnormalized.push_back (range.convertFrom0to1 (normalized.back()));
+                CHECK (reversed.convertFrom0to1 (normalized.back()) == range.convertFrom0to1 (1.0f - normalized.back()));
+                CHECK (reversed.convertTo0to1 (unnormalized.back()) == 1.0f - range.convertTo0to1 (unnormalized.back()));
+            }
+
+            std::vector<float> blockUnnormalized (normalized.size()), blockNormalized (normalized.size());
+            reversed.convertFrom0to1 (normalized.data(), blockUnnormalized.data(), (int) normalized.size());
+            reversed.convertTo0to1 (unnormalized.data(), blockNormalized.data(), (int) unnormalized.size());
+            for (size_t i = 0; i < normalized.size(); ++i)
+            {
+                CHECK (blockUnnormalized[i] == Catch::Approx (reversed.convertFrom0to1 (normalized[i])).margin (1e-5));
+                CHECK (blockNormalized[i] == Catch::Approx (reversed.convertTo0to1 (unnormalized[i])).margin (1e-6));
+            }
+
+            // reversing twice is the original
+            CHECK (melatonin::reversed (reversed).convertFrom0to1 (0.3f) == Catch::Approx (range.convertFrom0to1 (0.3f)));
+        };
+
+        checkReversed (melatonin::LinearRange (-1.0f, 1.0f));
+        checkReversed (melatonin::LogRange (0.0f, 15.0f, 6.0f, melatonin::Accuracy::fast));
+        checkReversed (melatonin::LogRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000));
+        checkReversed (melatonin::DecibelRange (-60.0f, 6.0f));
+        checkReversed (melatonin::HarmonicDecibelRange (3));
+        checkReversed (melatonin::IntRangeWithMidPoint (0, 100, 80));
+        checkReversed (melatonin::PiecewiseRange<>::logWithLinearStart (0.0f, 10000.0f, 6.0f, 1000));
+        checkReversed (melatonin::CompactRange::decibels (-60.0f, 6.0f));
+
+        constexpr auto fromTop = melatonin::reversed (melatonin::LinearRange (0.0f, 10.0f));
+        STATIC_REQUIRE (fromTop.convertFrom0to1 (0.25f) == 7.5f);
+
+        juce::NormalisableRange<float> converted = melatonin::reversed (melatonin::LogRange (0.0f, 15.0f));
+        CHECK (converted.convertFrom0to1 (0.0f) == Catch::Approx (15.0f));
+    }
+
+    SECTION ("the NormalisableRange converters fit in std::function without allocating")
+    {
+        // the same math as the type, one value at a time
+        auto checkConverters = [] (const auto& range) {
+            range.withConverters ([&] (auto from0to1, auto to0to1) {
+                STATIC_REQUIRE (melatonin::fitsInStdFunction<decltype (from0to1)>);
+                STATIC_REQUIRE (melatonin::fitsInStdFunction<decltype (to0to1)>);
+                for (int i = -10; i <= 110; ++i)
+                {
+                    const auto normalized = (float) i / 100.0f;
+                    const auto unnormalized = range.convertFrom0to1 (normalized);
+                    CHECK (from0to1 (range.getStart(), range.getEnd(), normalized) == unnormalized);
+                    CHECK (to0to1 (range.getStart(), range.getEnd(), unnormalized) == range.convertTo0to1 (unnormalized));
+                }
+                return 0;
+            });
+
+            juce::NormalisableRange<float> converted = range;
+            auto copy = converted;
+            CHECK (copy.convertFrom0to1 (0.3f) == range.convertFrom0to1 (0.3f));
+        };
+
+        for (auto accuracy : { melatonin::Accuracy::exact, melatonin::Accuracy::fast, melatonin::Accuracy::fastest })
+        {
+            checkConverters (melatonin::LogRange (20.0f, 20000.0f, 10.0f, accuracy));
+            checkConverters (melatonin::LogRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000, 0.25f, accuracy));
+            checkConverters (melatonin::DecibelRange (-60.0f, 6.0f, accuracy));
+            checkConverters (melatonin::HarmonicDecibelRange (3, -60.0f, accuracy));
+            checkConverters (melatonin::reversed (melatonin::LogRange (0.0f, 15.0f, 6.0f, accuracy)));
+            checkConverters (melatonin::reversed (melatonin::LogRangeWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f, 0.25f, accuracy)));
+        }
+        checkConverters (melatonin::LinearRange (-1.0f, 1.0f));
+        checkConverters (melatonin::IntRangeWithMidPoint (0, 100, 80));
+        checkConverters (melatonin::reversed (melatonin::IntRangeWithMidPoint (0, 100, 80)));
+    }
+
+    SECTION ("clamps normalized values like NormalisableRange")
+    {
+        auto range = melatonin::LogRange (0.0f, 15.0f);
+        CHECK (range.convertFrom0to1 (-0.5f) == Catch::Approx (0.0f));
+        CHECK (range.convertFrom0to1 (1.5f) == Catch::Approx (15.0f));
+        CHECK (range.convertTo0to1 (20.0f) == Catch::Approx (1.0f));
+    }
+
+    SECTION ("linear conversions can happen at compile time")
+    {
+        constexpr auto range = melatonin::LinearRange (-1.0f, 1.0f);
+        STATIC_REQUIRE (range.convertFrom0to1 (0.5f) == 0.0f);
+        STATIC_REQUIRE (melatonin::IntRangeWithMidPoint (0, 100, 80).convertFrom0to1 (0.5f) == 80.0f);
+    }
+}
+
+TEST_CASE ("Melatonin Parameters constexpr ranges")
+{
+    SECTION ("compile time exp2 and log2 match std")
+    {
+        STATIC_REQUIRE (melatonin::fastmath::constexprExp2 (6.0) == 64.0);
+        STATIC_REQUIRE (melatonin::fastmath::constexprExp2 (-3.0) == 0.125);
+        STATIC_REQUIRE (melatonin::fastmath::constexprLog2 (1024.0) == 10.0);
+
+        for (int i = -400; i <= 400; ++i)
+        {
+            auto x = (double) i * 0.137;
+            CHECK (melatonin::fastmath::constexprExp2 (x) == Catch::Approx (std::exp2 (x)).epsilon (1e-14));
+            auto y = std::exp2 (x);
+            CHECK (melatonin::fastmath::constexprLog2 (y) == Catch::Approx (std::log2 (y)).margin (1e-13));
+        }
+    }
+
+    SECTION ("a whole table of ranges at compile time")
+    {
+        static constexpr auto release = melatonin::log (0.0f, 15.0f, 6.0f);
+        static constexpr std::array<melatonin::LogRange, 3> envelope { melatonin::log (0.0f, 5.0f), melatonin::log (0.0f, 10.0f, 8.0f), release };
+        STATIC_REQUIRE (envelope[2].getEnd() == 15.0f);
+        STATIC_REQUIRE (envelope[1].getExponent() == 8.0f);
+
+        static constexpr auto gain = melatonin::decibels (-60.0f, 6.0f);
+        STATIC_REQUIRE (gain.convertFrom0to1 (1.0f) == 6.0f);
+        STATIC_REQUIRE (melatonin::linear (0.0f, 10.0f).convertFrom0to1 (0.5f) == 5.0f);
+        STATIC_REQUIRE (melatonin::intWithMidPoint (0, 100, 80).convertFrom0to1 (0.5f) == 80.0f);
+
+        static constexpr auto harmonic = melatonin::decibelsForHarmonic (4);
+        STATIC_REQUIRE (harmonic.getStart() == -100.0f);
+        STATIC_REQUIRE (harmonic.getEnd() < -12.0f);
+        STATIC_REQUIRE (harmonic.getEnd() > -12.1f);
+
+        static constexpr auto slow = melatonin::logWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f);
+        STATIC_REQUIRE (slow.getEnd() == 20.0f);
+    }
+
+    SECTION ("and they convert the same as the factories")
+    {
+        static constexpr auto release = melatonin::log (0.0f, 15.0f, 6.0f);
+        static constexpr auto slow = melatonin::logWithLinearStart (0.0f, 10000.0f, 6.0f, 1000);
+        static constexpr auto harmonic = melatonin::decibelsForHarmonic (10, -60.0f);
+        static constexpr auto gain = melatonin::decibels (-60.0f, 6.0f);
+
+        auto releaseFactory = logarithmicRange (0.0f, 15.0f, 6.0f);
+        auto slowFactory = logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000);
+        auto harmonicFactory = decibelRangeForHarmonic (10, -60.0f);
+
+        CHECK (harmonic.getEnd() == Catch::Approx (harmonicFactory.end));
+        for (int i = 0; i <= 100; ++i)
+        {
+            auto normalized = (float) i / 100.0f;
+            CHECK (release.convertFrom0to1 (normalized) == Catch::Approx (releaseFactory.convertFrom0to1 (normalized)).margin (1e-6));
+            CHECK (slow.convertFrom0to1 (normalized) == Catch::Approx (slowFactory.convertFrom0to1 (normalized)).margin (1e-3));
+            CHECK (harmonic.convertFrom0to1 (normalized) == Catch::Approx (harmonicFactory.convertFrom0to1 (normalized)).margin (1e-5));
+            CHECK (gain.gainFrom0to1 (normalized) == Catch::Approx (juce::Decibels::decibelsToGain (gain.convertFrom0to1 (normalized), -61.0f)).epsilon (1e-5));
+        }
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters range type benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("a block of 512 through a range type")
+    {
+        std::vector<float> results (512);
+        for (auto [name, accuracy] : { std::pair ("exact", melatonin::Accuracy::exact), std::pair ("fast", melatonin::Accuracy::fast), std::pair ("fastest", melatonin::Accuracy::fastest) })
+        {
+            const auto range = melatonin::LogRange (0.0f, 15.0f, 6.0f, accuracy);
+            BENCHMARK (std::string ("LogRange block of 512 ") + name)
+            {
+                range.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+                return results[0];
+            };
+
+            const auto withLinearStart = melatonin::LogRangeWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f, 0.25f, accuracy);
+            BENCHMARK (std::string ("LogRangeWithLinearStart block of 512 ") + name)
+            {
+                withLinearStart.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+                return results[0];
+            };
+        }
+    }
+
+    SECTION ("a block of 512 through IntRangeWithMidPoint")
+    {
+        const auto range = melatonin::IntRangeWithMidPoint (0, 100, 80);
+        std::vector<float> results (512);
+        BENCHMARK ("IntRangeWithMidPoint block of 512")
+        {
+            range.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+    }
+
+    SECTION ("reversing a range")
+    {
+        const auto range = melatonin::LogRange (0.0f, 15.0f);
+        const auto reversed = melatonin::reversed (range);
+        std::vector<float> results (512);
+        size_t i = 0;
+        BENCHMARK ("LogRange convertFrom0to1")
+        {
+            return range.convertFrom0to1 (normalized[i++ & 1023]);
+        };
+
+        BENCHMARK ("Reversed<LogRange> convertFrom0to1")
+        {
+            return reversed.convertFrom0to1 (normalized[i++ & 1023]);
+        };
+
+        BENCHMARK ("LogRange block of 512")
+        {
+            range.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+
+        BENCHMARK ("Reversed<LogRange> block of 512")
+        {
+            reversed.convertFrom0to1 (normalized.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+    }
+
+    SECTION ("setting up 2000 parameter ranges")
+    {
+        BENCHMARK ("2000 logarithmicRange factories")
+        {
+            std::vector<juce::NormalisableRange<float>> ranges;
+            ranges.reserve (2000);
+            for (int i = 0; i < 2000; ++i)
+                ranges.push_back (logarithmicRange (0.0f, (float) (i + 1)));
+            return ranges.back().end;
+        };
+
+        BENCHMARK ("2000 melatonin::log ranges")
+        {
+            std::vector<melatonin::LogRange> ranges;
+            ranges.reserve (2000);
+            for (int i = 0; i < 2000; ++i)
+                ranges.push_back (melatonin::log (0.0f, (float) (i + 1)));
+            return ranges.back().getEnd();
+        };
+
+        // a table known at compile time costs nothing at all
+        static constexpr std::array<melatonin::LogRange, 4> table { melatonin::log (0.0f, 1.0f), melatonin::log (0.0f, 5.0f), melatonin::log (0.0f, 10.0f), melatonin::log (0.0f, 15.0f) };
+        CHECK (melatonin::allocations::perCall ([&] (int n) { return table[(size_t) n & 3].convertFrom0to1 (0.5f); }) == 0);
+    }
+}
+#endif
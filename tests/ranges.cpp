@@ -1,8 +1,9 @@
-TEST_CASE ("Melatonin Parameters Ranges")
+// Every factory runs the same checks as float and as double
+TEMPLATE_TEST_CASE ("Melatonin Parameters Ranges", "", float, double)
 {
     SECTION ("linear range 0 to 1")
     {
-        auto range = linearRange (0.0f, 1.0f);
+        auto range = linearRange<TestType> (0.0f, 1.0f);
         SECTION ("handles 0 perfectly")
         {
             REQUIRE (range.convertTo0to1 (0.0f) == Catch::Approx (0.0f));
@@ -18,7 +19,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
     SECTION ("linear range -1 to 1")
     {
-        auto range = linearRange (-1.0f, 1.0f);
+        auto range = linearRange<TestType> (-1.0f, 1.0f);
         SECTION ("handles -1 perfectly")
         {
             REQUIRE (range.convertTo0to1 (-1.0f) == Catch::Approx (0.0f));
@@ -40,7 +41,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
     SECTION ("logarithmicRange 0 to 1 with default exponent of 6", "[parameters]")
     {
-        auto range = logarithmicRange (0.0f, 1.0f);
+        auto range = logarithmicRange<TestType> (0.0f, 1.0f);
 
         SECTION ("handles 0 perfectly")
         {
@@ -90,7 +91,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
     SECTION ("reversedLogarithimicRange 0 to 10 with default curve", "[parameters]")
     {
-        auto range = reversedLogarithmicRange (0.0f, 10.0f);
+        auto range = reversedLogarithmicRange<TestType> (0.0f, 10.0f);
 
         SECTION ("handles 0 perfectly")
         {
@@ -142,7 +143,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
     SECTION ("logarithmicRange 0 to 44100 with exponent of 10", "[parameters]")
     {
-        auto range = logarithmicRange (0.0f, 44100.0f, 10);
+        auto range = logarithmicRange<TestType> (0.0f, 44100.0f, 10);
 
         SECTION ("handles 0 perfectly")
         {
@@ -170,7 +171,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
         {
             SECTION ("unnormalized db values range from -100 to 0")
             {
-                auto dbRange = decibelRangeForHarmonic (1);
+                auto dbRange = decibelRangeForHarmonic<TestType> (1);
                 REQUIRE (dbRange.convertFrom0to1 (0.0f) == Catch::Approx (-100.f));
                 REQUIRE (dbRange.convertFrom0to1 (1.0f) == Catch::Approx (0.0f));
 
@@ -180,16 +181,16 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
             SECTION ("handles out of bounds input")
             {
-                auto boundsRange = decibelRangeForHarmonic (1);
+                auto boundsRange = decibelRangeForHarmonic<TestType> (1);
                 REQUIRE (boundsRange.convertTo0to1 (-120.f) == Catch::Approx (0.0f));
             }
 
             //  See docs/Per harmonic db ranges.numbers for example values
             SECTION ("for a harmonic")
             {
-                auto range2 = decibelRangeForHarmonic (2);
-                auto range3 = decibelRangeForHarmonic (3);
-                auto range10 = decibelRangeForHarmonic (10);
+                auto range2 = decibelRangeForHarmonic<TestType> (2);
+                auto range3 = decibelRangeForHarmonic<TestType> (3);
+                auto range10 = decibelRangeForHarmonic<TestType> (10);
 
                 SECTION ("caps the max gain at 1/f, where f is the harmonic number")
                 {
@@ -225,7 +226,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
     SECTION ("logarithmic range with linear start 0 to 1")
     {
-        auto range = logarithmicRangeWithLinearStart (0.0f, 1.0f, 6.0f, 0.25f, 0.25f);
+        auto range = logarithmicRangeWithLinearStart<TestType> (0.0f, 1.0f, 6.0f, 0.25f, 0.25f);
 
         SECTION ("handles 0 perfectly")
         {
@@ -263,7 +264,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
         SECTION ("logarithmic range with linear to 1000 then exp to 10000")
         {
-            range = logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000);
+            range = logarithmicRangeWithLinearStart<TestType> (0.0f, 10000.0f, 6.0f, 1000);
 
             SECTION ("handles 0 perfectly")
             {
@@ -305,7 +306,7 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
     SECTION ("decibelRange -30 to 0")
     {
-        auto range = decibelRange (-30.0f, 0.0f);
+        auto range = decibelRange<TestType> (-30.0f, 0.0f);
 
         SECTION ("Boundaries")
         {
@@ -322,16 +323,16 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
         SECTION ("Round-trip")
         {
-            float originalDb = -10.0f;
-            float normalized = range.convertTo0to1 (originalDb);
-            float backDb = range.convertFrom0to1 (normalized);
+            TestType originalDb = -10.0f;
+            TestType normalized = range.convertTo0to1 (originalDb);
+            TestType backDb = range.convertFrom0to1 (normalized);
             REQUIRE (backDb == Catch::Approx (originalDb).margin (0.001f));
         }
     }
 
     SECTION ("decibelRange -3 to +3")
     {
-        auto range = decibelRange (-3.0f, 3.0f);
+        auto range = decibelRange<TestType> (-3.0f, 3.0f);
 
         SECTION ("Boundaries")
         {
@@ -341,18 +342,18 @@ TEST_CASE ("Melatonin Parameters Ranges")
 
         SECTION ("Round-trip")
         {
-            float originalDb = 0.0f;
-            float normalized = range.convertTo0to1 (originalDb);
-            float backDb = range.convertFrom0to1 (normalized);
+            TestType originalDb = 0.0f;
+            TestType normalized = range.convertTo0to1 (originalDb);
+            TestType backDb = range.convertFrom0to1 (normalized);
             REQUIRE (backDb == Catch::Approx (originalDb).margin (0.001f));
         }
 
         SECTION ("MidpointCheck")
         {
-            float midpoint = 0.5f;
-            float dbVal = range.convertFrom0to1 (midpoint);
+            TestType midpoint = 0.5f;
+            TestType dbVal = range.convertFrom0to1 (midpoint);
             // Just an example check: confirm it's near the midpoint in amplitude space
-            float expectedAmp = std::pow (10.0f, dbVal / 20.0f);
+            TestType expectedAmp = std::pow ((TestType) 10, dbVal / 20);
             float minAmp = std::pow (10.0f, -3.0f / 20.0f);
             float maxAmp = std::pow (10.0f, 3.0f / 20.0f);
             float midAmp = minAmp * std::sqrt (maxAmp / minAmp);
@@ -360,3 +361,157 @@ TEST_CASE ("Melatonin Parameters Ranges")
         }
     }
 }
+
+TEST_CASE ("Melatonin Parameters double precision ranges")
+{
+    SECTION ("keep the ends of wide log ranges")
+    {
+        // the first Hz of a 0 to 44100 range is squeezed into the bottom 0.1% of the knob
+        auto range = logarithmicRange<double> (0.0, 44100.0, 10.0);
+        for (auto hz : { 0.001, 0.01, 0.5, 1.0, 44099.5 })
+            CHECK (range.convertFrom0to1 (range.convertTo0to1 (hz)) == Catch::Approx (hz).epsilon (1e-9));
+
+        auto floatRange = logarithmicRange (0.0f, 44100.0f, 10.0f);
+        CHECK (std::abs (floatRange.convertFrom0to1 (floatRange.convertTo0to1 (0.001f)) - 0.001f) > 1e-9f);
+    }
+
+    SECTION ("match the float ranges to float precision")
+    {
+        auto doubleRange = logarithmicRangeWithLinearStart<double> (0.0, 10000.0, 6.0, 1000.0);
+        auto floatRange = logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000);
+        for (int i = 0; i <= 100; ++i)
+        {
+            auto normalized = (float) i / 100.0f;
+            CHECK (doubleRange.convertFrom0to1 (normalized) == Catch::Approx (floatRange.convertFrom0to1 (normalized)).epsilon (1e-5));
+        }
+    }
+
+    SECTION ("the fast tiers still work, at float precision")
+    {
+        auto exact = logarithmicRange<double> (20.0, 20000.0, 10.0);
+        auto fast = logarithmicRange<double> (20.0, 20000.0, 10.0, melatonin::Accuracy::fast);
+        for (int i = 0; i <= 100; ++i)
+            CHECK (fast.convertFrom0to1 (i / 100.0) == Catch::Approx (exact.convertFrom0to1 (i / 100.0)).epsilon (1e-5));
+    }
+}
+
+TEST_CASE ("Melatonin Parameters block conversion matches the scalar ranges")
+{
+    // a few values outside of 0-1 and the unnormalized range check the clamping
+    std::vector<float> normalized;
+    for (int i = -2; i <= 102; ++i)
+        normalized.push_back ((float) i / 100.0f);
+
+    auto numValues = (int) normalized.size();
+    std::vector<float> unnormalized (normalized.size());
+    std::vector<float> roundTripped (normalized.size());
+
+    auto checkAgainst = [&] (const juce::NormalisableRange<float>& range, auto&& from0to1, auto&& to0to1) {
+        from0to1 (normalized.data(), unnormalized.data(), numValues);
+        for (size_t i = 0; i < normalized.size(); ++i)
+            CHECK (unnormalized[i] == Catch::Approx (range.convertFrom0to1 (normalized[i])).margin (1e-6));
+
+        // the log curves are undefined below their start, so only nudge past the end
+        unnormalized.back() = range.end + 1.0f;
+        to0to1 (unnormalized.data(), roundTripped.data(), numValues);
+        for (size_t i = 0; i < unnormalized.size(); ++i)
+            CHECK (roundTripped[i] == Catch::Approx (range.convertTo0to1 (unnormalized[i])).margin (1e-6));
+    };
+
+    SECTION ("linearRange")
+    {
+        checkAgainst (
+            linearRange (-1.0f, 1.0f),
+            [] (auto* src, auto* dest, int n) { melatonin::linearRangeFrom0to1 (src, dest, n, -1.0f, 1.0f); },
+            [] (auto* src, auto* dest, int n) { melatonin::linearRangeTo0to1 (src, dest, n, -1.0f, 1.0f); });
+    }
+
+    SECTION ("logarithmicRange")
+    {
+        checkAgainst (
+            logarithmicRange (0.0f, 44100.0f, 10.0f),
+            [] (auto* src, auto* dest, int n) { melatonin::logarithmicRangeFrom0to1 (src, dest, n, 0.0f, 44100.0f, 10.0f); },
+            [] (auto* src, auto* dest, int n) { melatonin::logarithmicRangeTo0to1 (src, dest, n, 0.0f, 44100.0f, 10.0f); });
+    }
+
+    SECTION ("logarithmicRangeWithLinearStart")
+    {
+        checkAgainst (
+            logarithmicRangeWithLinearStart (0.0f, 10000.0f, 6.0f, 1000.0f),
+            [] (auto* src, auto* dest, int n) { melatonin::logarithmicRangeWithLinearStartFrom0to1 (src, dest, n, 0.0f, 10000.0f, 6.0f, 1000.0f); },
+            [] (auto* src, auto* dest, int n) { melatonin::logarithmicRangeWithLinearStartTo0to1 (src, dest, n, 0.0f, 10000.0f, 6.0f, 1000.0f); });
+    }
+
+    SECTION ("reversedLogarithmicRange")
+    {
+        checkAgainst (
+            reversedLogarithmicRange (0.0f, 10.0f),
+            [] (auto* src, auto* dest, int n) { melatonin::reversedLogarithmicRangeFrom0to1 (src, dest, n, 0.0f, 10.0f); },
+            [] (auto* src, auto* dest, int n) { melatonin::reversedLogarithmicRangeTo0to1 (src, dest, n, 0.0f, 10.0f); });
+    }
+
+    SECTION ("intRangeWithMidPoint")
+    {
+        checkAgainst (
+            intRangeWithMidPoint (0, 100, 80),
+            [] (auto* src, auto* dest, int n) { melatonin::intRangeWithMidPointFrom0to1 (src, dest, n, 0, 100, 80); },
+            [] (auto* src, auto* dest, int n) { melatonin::intRangeWithMidPointTo0to1 (src, dest, n, 0, 100, 80); });
+    }
+
+    SECTION ("decibelRangeForHarmonic")
+    {
+        checkAgainst (
+            decibelRangeForHarmonic (3),
+            [] (auto* src, auto* dest, int n) { melatonin::decibelRangeForHarmonicFrom0to1 (src, dest, n, 3); },
+            [] (auto* src, auto* dest, int n) { melatonin::decibelRangeForHarmonicTo0to1 (src, dest, n, 3); });
+    }
+
+    SECTION ("decibelRange")
+    {
+        checkAgainst (
+            decibelRange(),
+            [] (auto* src, auto* dest, int n) { melatonin::decibelRangeFrom0to1 (src, dest, n); },
+            [] (auto* src, auto* dest, int n) { melatonin::decibelRangeTo0to1 (src, dest, n); });
+    }
+
+    SECTION ("decibelRange -30 to 0")
+    {
+        checkAgainst (
+            decibelRange (-30.0f, 0.0f),
+            [] (auto* src, auto* dest, int n) { melatonin::decibelRangeFrom0to1 (src, dest, n, -30.0f, 0.0f); },
+            [] (auto* src, auto* dest, int n) { melatonin::decibelRangeTo0to1 (src, dest, n, -30.0f, 0.0f); });
+    }
+
+    SECTION ("converts in place")
+    {
+        auto inPlace = normalized;
+        melatonin::logarithmicRangeFrom0to1 (inPlace.data(), inPlace.data(), numValues, 0.0f, 15.0f);
+        melatonin::logarithmicRangeFrom0to1 (normalized.data(), unnormalized.data(), numValues, 0.0f, 15.0f);
+        CHECK (inPlace == unnormalized);
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters range factory benchmarks", "[!benchmark]")
+{
+    SECTION ("factories")
+    {
+        melatonin::benchmarks::benchmarkRange ("linearRange", linearRange (-1.0f, 1.0f));
+        melatonin::benchmarks::benchmarkRange ("logarithmicRange", logarithmicRange (0.0f, 15.0f));
+        melatonin::benchmarks::benchmarkRange ("logarithmicRangeWithLinearStart", logarithmicRangeWithLinearStart (0.0f, 20.0f, 6.0f, 0.03f));
+        melatonin::benchmarks::benchmarkRange ("reversedLogarithmicRange", reversedLogarithmicRange (0.0f, 15.0f));
+        melatonin::benchmarks::benchmarkRange ("intRangeWithMidPoint", intRangeWithMidPoint (0, 100, 80));
+        melatonin::benchmarks::benchmarkRange ("decibelRangeForHarmonic", decibelRangeForHarmonic (3));
+        melatonin::benchmarks::benchmarkRange ("decibelRange()", decibelRange());
+        melatonin::benchmarks::benchmarkRange ("decibelRange (min, max)", decibelRange (-30.0f, 0.0f));
+    }
+
+    SECTION ("each accuracy")
+    {
+        for (auto [name, accuracy] : { std::pair ("exact", melatonin::Accuracy::exact), std::pair ("fast", melatonin::Accuracy::fast), std::pair ("fastest", melatonin::Accuracy::fastest) })
+        {
+            melatonin::benchmarks::benchmarkRange (std::string ("logarithmicRange ") + name, logarithmicRange (0.0f, 15.0f, 6.0f, accuracy));
+        }
+    }
+}
+#endif
@@ -0,0 +1,174 @@
+TEST_CASE ("Melatonin Parameters range smoother")
+{
+    SECTION ("starts idle at the initial value")
+    {
+        melatonin::RangeSmoother<melatonin::LogRange> smoother { melatonin::LogRange (0.0f, 15.0f), 2.0f };
+        smoother.reset (48000.0, 0.01);
+        CHECK_FALSE (smoother.isSmoothing());
+        CHECK (smoother.getCurrentValue() == Catch::Approx (2.0f));
+
+        std::vector<float> block (64);
+        smoother.process (block.data(), (int) block.size());
+        for (auto value : block)
+            CHECK (value == smoother.getTargetValue());
+    }
+
+    SECTION ("ramps linearly in the normalized domain, not the unnormalized one")
+    {
+        const auto range = melatonin::LogRange (0.0f, 15.0f);
+        melatonin::RangeSmoother<melatonin::LogRange> smoother { range, 0.0f };
+        smoother.reset (1000.0, 0.1);
+        smoother.setTargetValue (15.0f);
+        REQUIRE (smoother.isSmoothing());
+
+        std::vector<float> block (100);
+        smoother.process (block.data(), (int) block.size());
+        for (size_t i = 0; i < block.size(); ++i)
+            CHECK (range.convertTo0to1 (block[i]) == Catch::Approx ((float) (i + 1) / 100.0f).margin (1e-5));
+
+        // halfway through the ramp is halfway along the knob, nowhere near 7.5s
+        CHECK (block[49] == Catch::Approx (range.convertFrom0to1 (0.5f)));
+        CHECK (block[49] < 2.0f);
+
+        CHECK (block.back() == 15.0f);
+        CHECK_FALSE (smoother.isSmoothing());
+    }
+
+    SECTION ("block, per sample and skipped ramps all agree")
+    {
+        const auto range = melatonin::DecibelRange (-60.0f, 0.0f);
+        melatonin::RangeSmoother<melatonin::DecibelRange> inBlocks { range, -60.0f }, perSample { range, -60.0f }, skipping { range, -60.0f };
+        for (auto* smoother : { &inBlocks, &perSample, &skipping })
+        {
+            smoother->reset (100.0, 1.0);
+            smoother->setTargetValue (-6.0f);
+        }
+
+        // a ramp of 100 samples over blocks of 32, so it ends partway through a block
+        std::vector<float> block (32);
+        for (int b = 0; b < 4; ++b)
+        {
+            inBlocks.process (block.data(), (int) block.size());
+            for (auto value : block)
+                CHECK (value == Catch::Approx (perSample.getNextValue()).margin (1e-4));
+
+            skipping.skip ((int) block.size());
+            CHECK (skipping.getCurrentValue() == Catch::Approx (block.back()).margin (1e-4));
+        }
+
+        CHECK (block[3] == Catch::Approx (-6.0f).margin (1e-4));
+        CHECK (block.back() == Catch::Approx (-6.0f).margin (1e-4));
+    }
+
+    SECTION ("a new target starts from wherever the ramp is")
+    {
+        melatonin::RangeSmoother<melatonin::LinearRange> smoother { melatonin::LinearRange (0.0f, 1.0f), 0.0f };
+        smoother.reset (100.0, 0.1);
+        smoother.setTargetValue (1.0f);
+        smoother.skip (5);
+        CHECK (smoother.getCurrentValue() == Catch::Approx (0.5f));
+
+        smoother.setTargetValue (0.0f);
+        CHECK (smoother.getNextValue() == Catch::Approx (0.45f));
+
+        // the same target again doesn't restart anything
+        smoother.setTargetValue (0.0f);
+        CHECK (smoother.getNextValue() == Catch::Approx (0.4f));
+    }
+
+    SECTION ("setting the same target again doesn't convert it again")
+    {
+        struct CountingRange
+        {
+            melatonin::LinearRange range { 0.0f, 10.0f };
+            int* numConversions;
+
+            float convertFrom0to1 (float normalized) const { return range.convertFrom0to1 (normalized); }
+            float convertTo0to1 (float unnormalized) const
+            {
+                ++*numConversions;
+                return range.convertTo0to1 (unnormalized);
+            }
+        };
+
+        int numConversions = 0;
+        melatonin::RangeSmoother<CountingRange> smoother { CountingRange { melatonin::LinearRange (0.0f, 10.0f), &numConversions }, 0.0f };
+        smoother.reset (100.0, 0.1);
+        numConversions = 0;
+
+        for (int block = 0; block < 100; ++block)
+            smoother.setTargetValue (5.0f);
+        CHECK (numConversions == 1);
+
+        // out of the range, it's clamped the first time and then left alone
+        for (int block = 0; block < 100; ++block)
+            smoother.setTargetValue (20.0f);
+        CHECK (numConversions == 2);
+        CHECK (smoother.getTargetValue() == 10.0f);
+
+        smoother.setTargetValue (5.0f);
+        CHECK (numConversions == 3);
+    }
+
+    SECTION ("without a ramp length it jumps")
+    {
+        melatonin::RangeSmoother<melatonin::LinearRange> smoother { melatonin::LinearRange (0.0f, 1.0f), 0.0f };
+        smoother.setTargetValue (0.75f);
+        CHECK_FALSE (smoother.isSmoothing());
+        CHECK (smoother.getCurrentValue() == 0.75f);
+    }
+
+    SECTION ("takes the juce::NormalisableRange factories too")
+    {
+        const auto range = decibelRange (-30.0f, 0.0f);
+        melatonin::RangeSmoother<juce::NormalisableRange<float>> smoother { range, -30.0f };
+        melatonin::RangeSmoother<melatonin::DecibelRange> typed { melatonin::DecibelRange (-30.0f, 0.0f), -30.0f };
+        smoother.reset (1000.0, 0.064);
+        typed.reset (1000.0, 0.064);
+        smoother.setTargetValue (0.0f);
+        typed.setTargetValue (0.0f);
+
+        std::vector<float> block (64), typedBlock (64);
+        smoother.process (block.data(), 64);
+        typed.process (typedBlock.data(), 64);
+        for (size_t i = 0; i < block.size(); ++i)
+            CHECK (block[i] == Catch::Approx (typedBlock[i]).margin (1e-4));
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters range smoother benchmarks", "[!benchmark]")
+{
+    SECTION ("smoothing a block of 512")
+    {
+        std::vector<float> results (512);
+        melatonin::RangeSmoother<melatonin::LogRange> smoother { melatonin::LogRange (0.0f, 15.0f) };
+        smoother.reset (48000.0, 1.0);
+
+        float target = 0.0f;
+        BENCHMARK ("RangeSmoother<LogRange> ramping")
+        {
+            if (! smoother.isSmoothing())
+                smoother.setTargetValue (target = 15.0f - target);
+            smoother.process (results.data(), (int) results.size());
+            return results[0];
+        };
+
+        BENCHMARK ("RangeSmoother<LogRange> ramping per sample")
+        {
+            if (! smoother.isSmoothing())
+                smoother.setTargetValue (target = 15.0f - target);
+            for (auto& result : results)
+                result = smoother.getNextValue();
+            return results[0];
+        };
+
+        smoother.setCurrentAndTargetValue (1.0f);
+        BENCHMARK ("RangeSmoother<LogRange> idle")
+        {
+            smoother.process (results.data(), (int) results.size());
+            return results[0];
+        };
+    }
+}
+#endif
@@ -0,0 +1,191 @@
+TEST_CASE ("Melatonin Parameters snapping")
+{
+    // lots of values in and around each range, including exact halfway points
+    auto valuesBetween = [] (float start, float end) {
+        std::vector<float> values;
+        for (int i = -20; i <= 220; ++i)
+            values.push_back (start + (end - start) * (float) i / 200.0f);
+        for (int i = (int) start; i <= (int) end; ++i)
+            values.push_back ((float) i + 0.5f);
+        return values;
+    };
+
+    // the block version of a snapping function should match the range snapping one value at a time
+    auto checkBlockMatchesScalar = [] (const auto& snap, const juce::NormalisableRange<float>& range, const std::vector<float>& values) {
+        std::vector<float> snapped (values.size());
+        snap (range.start, range.end, values.data(), snapped.data(), (int) values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            CHECK (snapped[i] == Catch::Approx (range.snapToLegalValue (values[i])).margin (1e-6));
+    };
+
+    SECTION ("interval snapping is what NormalisableRange does on its own")
+    {
+        juce::NormalisableRange<float> plain (-3.0f, 7.0f, 0.25f);
+        auto snapping = melatonin::withSnapping (linearRange (-3.0f, 7.0f), melatonin::SnapToInterval<> { 0.25f });
+        CHECK (snapping.interval == 0.25f);
+
+        for (auto value : valuesBetween (-3.0f, 7.0f))
+            CHECK (snapping.snapToLegalValue (value) == plain.snapToLegalValue (value));
+
+        CHECK (snapping.snapToLegalValue (1.1f) == 1.0f);
+        CHECK (snapping.snapToLegalValue (1.125f) == 1.25f);
+        CHECK (snapping.snapToLegalValue (100.0f) == 7.0f);
+
+        checkBlockMatchesScalar (melatonin::SnapToInterval<> { 0.25f }, snapping, valuesBetween (-3.0f, 7.0f));
+        checkBlockMatchesScalar (melatonin::SnapToInterval<> { 0.25f }, plain, valuesBetween (-3.0f, 7.0f));
+        checkBlockMatchesScalar (melatonin::SnapToInterval<>(), juce::NormalisableRange<float> (0.0f, 1.0f), valuesBetween (0.0f, 1.0f));
+    }
+
+    SECTION ("a tiny interval and far out of range values snap the same in blocks")
+    {
+        // billions of steps, more than fit in an int
+        const melatonin::SnapToInterval<> tiny { 1e-6f };
+        const std::vector<float> values { 2500.0f, 2999.0f, 1e10f, -1e10f, 3000.0f, 0.0f, 1234.5f, 2999.9f, 1e30f, -1e30f };
+        std::vector<float> snapped (values.size());
+        tiny (0.0f, 3000.0f, values.data(), snapped.data(), (int) values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            CHECK (snapped[i] == tiny (0.0f, 3000.0f, values[i]));
+
+        CHECK (snapped[0] == 2500.0f);
+        CHECK (snapped[1] == 2999.0f);
+        CHECK (snapped[2] == 3000.0f);
+        CHECK (snapped[3] == 0.0f);
+    }
+
+    SECTION ("any factory can snap")
+    {
+        auto release = melatonin::withSnapping (logarithmicRange (0.0f, 15.0f), melatonin::SnapToInterval<> { 0.5f });
+        CHECK (release.snapToLegalValue (3.3f) == 3.5f);
+        CHECK (release.convertFrom0to1 (0.5f) == Catch::Approx (logarithmicRange (0.0f, 15.0f).convertFrom0to1 (0.5f)));
+
+        auto gain = melatonin::withSnapping (decibelRange (-60.0f, 6.0f), melatonin::SnapToInt());
+        CHECK (gain.interval == 1.0f);
+        CHECK (gain.snapToLegalValue (-12.4f) == -12.0f);
+        checkBlockMatchesScalar (melatonin::SnapToInt(), gain, valuesBetween (-60.0f, 6.0f));
+
+        // range types snap without going through another NormalisableRange
+        auto semitones = melatonin::withSnapping (melatonin::LinearRange (-24.0f, 24.0f), melatonin::SnapToInt());
+        CHECK (semitones.snapToLegalValue (7.3f) == 7.0f);
+        CHECK (semitones.convertFrom0to1 (0.75f) == 12.0f);
+
+        auto precise = melatonin::withSnapping (linearRange<double> (0.0, 1.0), melatonin::SnapToInterval<double> { 0.1 });
+        CHECK (precise.snapToLegalValue (0.33) == Catch::Approx (0.3));
+    }
+
+    SECTION ("int snapping matches intRangeWithMidPoint")
+    {
+        auto range = intRangeWithMidPoint (0, 100, 80);
+        CHECK (range.snapToLegalValue (16.4f) == 16.0f);
+        CHECK (range.snapToLegalValue (16.5f) == 16.0f);
+        CHECK (range.snapToLegalValue (17.5f) == 18.0f);
+        CHECK (range.snapToLegalValue (-5.0f) == 0.0f);
+        checkBlockMatchesScalar (melatonin::SnapToInt(), range, valuesBetween (0.0f, 100.0f));
+
+        // the range type's conversion snaps the same way
+        checkBlockMatchesScalar (melatonin::SnapToInt(), melatonin::IntRangeWithMidPoint (-10, 10, 2), valuesBetween (-10.0f, 10.0f));
+    }
+
+    SECTION ("snapping to a set of legal values")
+    {
+        // note divisions, out of order and with a duplicate
+        melatonin::SnapToValues<> divisions ({ 1.0f / 4, 1.0f / 16, 1.0f / 8, 1.0f / 2, 1.0f, 1.0f / 8, 3.0f / 16 });
+        CHECK (divisions.getNumValues() == 6u);
+        CHECK (divisions.getValue (0) == 1.0f / 16);
+
+        auto range = melatonin::withSnapping (linearRange (0.0f, 1.0f), divisions);
+        CHECK (range.snapToLegalValue (0.0f) == 1.0f / 16);
+        CHECK (range.snapToLegalValue (0.2f) == 3.0f / 16);
+        CHECK (range.snapToLegalValue (0.24f) == 1.0f / 4);
+        CHECK (range.snapToLegalValue (0.9f) == 1.0f);
+        CHECK (range.snapToLegalValue (5.0f) == 1.0f);
+
+        // halfway between 1/4 and 1/2 goes up
+        CHECK (range.snapToLegalValue (0.375f) == 1.0f / 2);
+
+        // compare against a plain search for the nearest
+        auto nearest = [&] (float value) {
+            auto best = divisions.getValue (0);
+            for (size_t i = 0; i < divisions.getNumValues(); ++i)
+                if (std::abs (value - divisions.getValue (i)) <= std::abs (value - best))
+                    best = divisions.getValue (i);
+            return best;
+        };
+
+        for (auto value : valuesBetween (-0.5f, 1.5f))
+            CHECK (range.snapToLegalValue (value) == nearest (value));
+
+        checkBlockMatchesScalar (divisions, range, valuesBetween (-0.5f, 1.5f));
+
+        // never past the last legal value, and NaN goes to the first
+        melatonin::SnapToValues<> quarters ({ 0.25f, 0.5f, 1.0f });
+        CHECK (quarters (0.0f, 1.0f, std::numeric_limits<float>::infinity()) == 1.0f);
+        CHECK (quarters (0.0f, 1.0f, -std::numeric_limits<float>::infinity()) == 0.25f);
+        CHECK (quarters (0.0f, 1.0f, std::numeric_limits<float>::quiet_NaN()) == 0.25f);
+        CHECK (quarters (0.0f, 1.0f, std::numeric_limits<float>::max()) == 1.0f);
+    }
+
+    SECTION ("a single legal value, and every table size")
+    {
+        melatonin::SnapToValues<> one ({ 0.5f });
+        CHECK (one (0.0f, 1.0f, -100.0f) == 0.5f);
+        CHECK (one (0.0f, 1.0f, 100.0f) == 0.5f);
+        CHECK (one (0.0f, 1.0f, std::numeric_limits<float>::infinity()) == 0.5f);
+        CHECK (one (0.0f, 1.0f, -std::numeric_limits<float>::infinity()) == 0.5f);
+        CHECK (one (0.0f, 1.0f, std::numeric_limits<float>::quiet_NaN()) == 0.5f);
+
+        for (int numValues = 1; numValues <= 40; ++numValues)
+        {
+            std::vector<float> legal;
+            for (int i = 0; i < numValues; ++i)
+                legal.push_back ((float) (i * i));
+
+            melatonin::SnapToValues<> squares (legal);
+            for (int i = 0; i < numValues; ++i)
+            {
+                CHECK (squares (0.0f, 1.0f, (float) (i * i)) == (float) (i * i));
+                CHECK (squares (0.0f, 1.0f, (float) (i * i) + 0.4f) == (float) (i * i));
+            }
+        }
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters snapping benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("snapping a block of 512")
+    {
+        std::vector<float> values, results (512);
+        for (size_t i = 0; i < results.size(); ++i)
+            values.push_back (normalized[i] * 4.0f);
+
+        const auto divisions = melatonin::SnapToValues<> ({ 1.0f / 32, 1.0f / 16, 1.0f / 8, 3.0f / 16, 1.0f / 4, 3.0f / 8, 1.0f / 2, 3.0f / 4, 1.0f, 1.5f, 2.0f, 3.0f, 4.0f });
+        const auto range = melatonin::withSnapping (linearRange (0.0f, 4.0f), divisions);
+        BENCHMARK ("snapToLegalValue per value, 13 legal values")
+        {
+            for (size_t i = 0; i < results.size(); ++i)
+                results[i] = range.snapToLegalValue (values[i]);
+            return results[0];
+        };
+
+        BENCHMARK ("SnapToValues block, 13 legal values")
+        {
+            divisions (0.0f, 4.0f, values.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+
+        BENCHMARK ("SnapToInterval block")
+        {
+            melatonin::SnapToInterval<> { 0.25f } (0.0f, 4.0f, values.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+
+        BENCHMARK ("SnapToInt block")
+        {
+            melatonin::SnapToInt() (0.0f, 4.0f, values.data(), results.data(), (int) results.size());
+            return results[0];
+        };
+    }
+}
+#endif
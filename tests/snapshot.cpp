@@ -0,0 +1,196 @@
+TEST_CASE ("Melatonin Parameters snapshot")
+{
+    const std::vector<std::string_view> ids { "attack", "release", "cutoff", "resonance", "band1", "band2", "band3", "band4", "gain" };
+
+    // a bank where every preset is a bit different
+    auto presetValue = [] (int preset, int parameter) {
+        return (float) ((preset * 31 + parameter * 17) % 101) / 100.0f;
+    };
+
+    auto makeBank = [&] (melatonin::SnapshotWriter::Encoding encoding, int numPresets) {
+        auto writer = melatonin::SnapshotWriter::create (ids, encoding);
+        REQUIRE (writer.has_value());
+        std::vector<float> normalized (ids.size());
+        for (int preset = 0; preset < numPresets; ++preset)
+        {
+            for (size_t parameter = 0; parameter < ids.size(); ++parameter)
+                normalized[parameter] = presetValue (preset, (int) parameter);
+            writer->addPreset (normalized.data());
+        }
+        CHECK (writer->getNumPresets() == numPresets);
+        return writer->toMemoryBlock();
+    };
+
+    SECTION ("reads back what was written")
+    {
+        for (auto [encoding, margin] : { std::pair (melatonin::SnapshotWriter::Encoding::float32, 0.0), std::pair (melatonin::SnapshotWriter::Encoding::uint16, 1.0 / 131070) })
+        {
+            const auto block = makeBank (encoding, 100);
+            const melatonin::SnapshotView bank (block.getData(), block.getSize());
+            REQUIRE (bank.isValid());
+            CHECK (bank.getNumPresets() == 100);
+            CHECK (bank.getNumParameters() == (int) ids.size());
+            CHECK (bank.getEncoding() == encoding);
+
+            for (size_t parameter = 0; parameter < ids.size(); ++parameter)
+                CHECK (bank.indexOf (ids[parameter]) == (int) parameter);
+            CHECK (bank.indexOf ("not a parameter") == -1);
+            CHECK (bank.indexOf (juce::String ("cutoff")) == 2);
+
+            for (int preset = 0; preset < 100; ++preset)
+                for (int parameter = 0; parameter < (int) ids.size(); ++parameter)
+                    CHECK (bank.getNormalized (preset, parameter) == Catch::Approx (presetValue (preset, parameter)).margin (margin));
+        }
+
+        // the float encoding is exact, the uint16 one is half the size
+        CHECK (makeBank (melatonin::SnapshotWriter::Encoding::float32, 1000).getSize() > makeBank (melatonin::SnapshotWriter::Encoding::uint16, 1000).getSize() * 3 / 2);
+    }
+
+    SECTION ("plain values go through the range")
+    {
+        const auto block = makeBank (melatonin::SnapshotWriter::Encoding::float32, 50);
+        const melatonin::SnapshotView bank (block.getData(), block.getSize());
+        const auto frequency = melatonin::LogRange (20.0f, 20000.0f, 10.0f);
+
+        std::array<float, 4> bands;
+        bank.getValues (7, bank.indexOf ("band1"), 4, frequency, bands.data());
+        for (int band = 0; band < 4; ++band)
+            CHECK (bands[(size_t) band] == Catch::Approx (frequency.convertFrom0to1 (presetValue (7, 4 + band))));
+
+        std::vector<float> cutoffs (50);
+        bank.getValuesForAllPresets (bank.indexOf ("cutoff"), logarithmicRange (20.0f, 20000.0f, 10.0f), cutoffs.data());
+        for (int preset = 0; preset < 50; ++preset)
+            CHECK (cutoffs[(size_t) preset] == Catch::Approx (frequency.convertFrom0to1 (presetValue (preset, 2))));
+    }
+
+    SECTION ("from a file, mapped into memory")
+    {
+        auto file = juce::File::createTempFile (".snapshot");
+        auto writer = melatonin::SnapshotWriter::create ({ "mix", "drive" }, melatonin::SnapshotWriter::Encoding::uint16);
+        REQUIRE (writer.has_value());
+        const std::array<float, 2> preset { 0.25f, 1.5f };
+        writer->addPreset (preset.data());
+        REQUIRE (writer->writeTo (file));
+
+        {
+            const melatonin::MappedSnapshot bank (file);
+            REQUIRE (bank.isValid());
+            CHECK (bank.getNormalized (0, bank.indexOf ("mix")) == Catch::Approx (0.25f).margin (1e-5));
+
+            // normalized values are clamped on the way in
+            CHECK (bank.getNormalized (0, bank.indexOf ("drive")) == 1.0f);
+        }
+
+        file.deleteFile();
+        CHECK_FALSE (melatonin::MappedSnapshot (file).isValid());
+    }
+
+    SECTION ("rejects anything that isn't a whole snapshot")
+    {
+        const auto block = makeBank (melatonin::SnapshotWriter::Encoding::uint16, 10);
+        CHECK (melatonin::SnapshotView (block.getData(), block.getSize()).isValid());
+        CHECK_FALSE (melatonin::SnapshotView (block.getData(), block.getSize() - 1).isValid());
+        CHECK_FALSE (melatonin::SnapshotView (block.getData(), 16).isValid());
+        CHECK_FALSE (melatonin::SnapshotView (nullptr, 0).isValid());
+        CHECK (melatonin::SnapshotView().indexOf ("attack") == -1);
+
+        auto corrupted = block;
+        corrupted[0] = 'X';
+        CHECK_FALSE (melatonin::SnapshotView (corrupted.getData(), corrupted.getSize()).isValid());
+
+        // header fields, at their offsets in snapshot::Header
+        auto withHeaderField = [&] (size_t offset, uint32_t value) {
+            auto patched = block;
+            std::memcpy (static_cast<char*> (patched.getData()) + offset, &value, sizeof (value));
+            return patched;
+        };
+        for (auto numParameters : { 1u << 31, ~0u, melatonin::snapshot::maxParameters + 1, 100000u })
+        {
+            const auto patched = withHeaderField (8, numParameters);
+            CHECK_FALSE (melatonin::SnapshotView (patched.getData(), patched.getSize()).isValid());
+        }
+        for (auto numPresets : { 11u, 1u << 31, ~0u })
+        {
+            const auto patched = withHeaderField (12, numPresets);
+            CHECK_FALSE (melatonin::SnapshotView (patched.getData(), patched.getSize()).isValid());
+        }
+
+        // the hash table: a column outside the bank, and a table with no empty slot
+        const auto* header = static_cast<const melatonin::snapshot::Header*> (block.getData());
+        auto withSlots = [&] (auto&& patchSlot) {
+            auto patched = block;
+            auto* slots = static_cast<char*> (patched.getData()) + sizeof (melatonin::snapshot::Header);
+            for (uint32_t i = 0; i < header->tableSize; ++i)
+            {
+                melatonin::snapshot::Slot slot;
+                std::memcpy (&slot, slots + i * sizeof (slot), sizeof (slot));
+                patchSlot (slot);
+                std::memcpy (slots + i * sizeof (slot), &slot, sizeof (slot));
+            }
+            return patched;
+        };
+
+        const auto outOfBounds = withSlots ([] (auto& slot) {
+            if (slot.hash == melatonin::snapshot::hashID ("release"))
+                slot.column = 1000000;
+        });
+        const melatonin::SnapshotView withBadColumn (outOfBounds.getData(), outOfBounds.getSize());
+        CHECK (withBadColumn.indexOf ("release") == -1);
+        CHECK (withBadColumn.indexOf ("attack") == 0);
+
+        const auto full = withSlots ([] (auto& slot) {
+            if (slot.column == melatonin::snapshot::emptySlot)
+                slot = { 1, 0, 0 };
+        });
+        const melatonin::SnapshotView withFullTable (full.getData(), full.getSize());
+        CHECK (withFullTable.indexOf ("not a parameter") == -1);
+        CHECK (withFullTable.indexOf ("cutoff") == 2);
+    }
+
+    SECTION ("the writer refuses IDs it couldn't tell apart")
+    {
+        CHECK_FALSE (melatonin::SnapshotWriter::create ({ "attack", "release", "attack" }).has_value());
+        CHECK (melatonin::SnapshotWriter::create ({ "attack", "release" }).has_value());
+        CHECK (melatonin::SnapshotWriter::create ({}).has_value());
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters snapshot benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("a bank of 10000 presets")
+    {
+        std::vector<std::string> ids;
+        for (int i = 0; i < 64; ++i)
+            ids.push_back ("parameter" + std::to_string (i));
+
+        auto writer = melatonin::SnapshotWriter::create (std::vector<std::string_view> (ids.begin(), ids.end()), melatonin::SnapshotWriter::Encoding::uint16);
+        for (size_t preset = 0; preset < 10000; ++preset)
+            writer->addPreset (normalized.data() + (preset & 511));
+        const auto block = writer->toMemoryBlock();
+
+        std::vector<float> values (10000);
+        size_t i = 0;
+        BENCHMARK ("open a bank and read a preset's 64 values")
+        {
+            const melatonin::SnapshotView bank (block.getData(), block.getSize());
+            bank.getValues ((int) (i++ % 10000), 0, 64, melatonin::LogRange (0.0f, 15.0f), values.data());
+            return values[0];
+        };
+
+        const melatonin::SnapshotView bank (block.getData(), block.getSize());
+        BENCHMARK ("look up a parameter ID")
+        {
+            return bank.indexOf (ids[i++ & 63]);
+        };
+
+        BENCHMARK ("one parameter across 10000 presets")
+        {
+            bank.getValuesForAllPresets (bank.indexOf ("parameter12"), melatonin::LogRange (0.0f, 15.0f), values.data());
+            return values[0];
+        };
+    }
+}
+#endif
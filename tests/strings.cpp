@@ -34,31 +34,31 @@ TEST_CASE ("timeValueFromString", "[parameters]")
     }
 }
 
-TEST_CASE ("intRangeWithMidPoint")
+TEMPLATE_TEST_CASE ("intRangeWithMidPoint", "", float, double)
 {
     SECTION ("from 0 to 1")
     {
         SECTION ("returns the midpoint when the value is 0.5")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             REQUIRE (range.convertFrom0to1 (0.5f) == Catch::Approx (80.f));
         }
 
         SECTION ("returns the min when the value is 0")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             REQUIRE (range.convertFrom0to1 (0.0f) == Catch::Approx (0.f));
         }
 
         SECTION ("returns the max when the value is 1")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             REQUIRE (range.convertFrom0to1 (1.0f) == Catch::Approx (100.f));
         }
 
         SECTION ("linear distribution under midpoint")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             CHECK (range.convertFrom0to1 (0.1f) == Catch::Approx (16.f));
             CHECK (range.convertFrom0to1 (0.2f) == Catch::Approx (32.f));
             CHECK (range.convertFrom0to1 (0.3f) == Catch::Approx (48.f));
@@ -66,7 +66,7 @@ TEST_CASE ("intRangeWithMidPoint")
 
         SECTION ("linear distribution above midpoint")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             CHECK (range.convertFrom0to1 (0.6f) == Catch::Approx (84.f));
             CHECK (range.convertFrom0to1 (0.7f) == Catch::Approx (88.f));
             CHECK (range.convertFrom0to1 (0.8f) == Catch::Approx (92.f));
@@ -77,25 +77,25 @@ TEST_CASE ("intRangeWithMidPoint")
     {
         SECTION ("returns 0.5 when the value is the midpoint")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             REQUIRE (range.convertTo0to1 (80.f) == Catch::Approx (0.5f));
         }
 
         SECTION ("returns 0 when the value is the min")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             REQUIRE (range.convertTo0to1 (0.f) == Catch::Approx (0.0f));
         }
 
         SECTION ("returns 1 when the value is the max")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             REQUIRE (range.convertTo0to1 (100.f) == Catch::Approx (1.0f));
         }
 
         SECTION ("linear distribution below midpoint")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             CHECK (range.convertTo0to1 (16.f) == Catch::Approx (0.1f));
             CHECK (range.convertTo0to1 (32.f) == Catch::Approx (0.2f));
             CHECK (range.convertTo0to1 (48.f) == Catch::Approx (0.3f));
@@ -103,7 +103,7 @@ TEST_CASE ("intRangeWithMidPoint")
 
         SECTION ("linear distribution above midpoint")
         {
-            auto range = intRangeWithMidPoint (0, 100, 80);
+            auto range = intRangeWithMidPoint<TestType> (0, 100, 80);
             CHECK (range.convertTo0to1 (84.f) == Catch::Approx (0.6f));
             CHECK (range.convertTo0to1 (88.f) == Catch::Approx (0.7f));
             CHECK (range.convertTo0to1 (92.f) == Catch::Approx (0.8f));
@@ -111,50 +111,51 @@ TEST_CASE ("intRangeWithMidPoint")
     }
 }
 
-TEST_CASE ("Melatonin Parameters to/from string")
+// The stringFrom* lambdas format a float or a double the same way
+TEMPLATE_TEST_CASE ("Melatonin Parameters to/from string", "", float, double)
 {
     SECTION ("stringFromTimeValue", "[parameters]")
     {
         SECTION ("returns ms under 1s, removes 0s from decimal")
         {
-            REQUIRE (stringFromTimeValue (0.f) == "0ms");
-            REQUIRE (stringFromTimeValue (0.001f) == "1ms");
-            REQUIRE (stringFromTimeValue (0.01f) == "10ms");
-            REQUIRE (stringFromTimeValue (0.1f) == "100ms");
-            REQUIRE (stringFromTimeValue (0.499f) == "499ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.f) == "0ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.001f) == "1ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.01f) == "10ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.1f) == "100ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.499f) == "499ms");
         }
 
         SECTION ("returns s over .5s, always has 2 digits of precision")
         {
-            REQUIRE (stringFromTimeValue (0.5f) == "0.50s");
-            REQUIRE (stringFromTimeValue (0.6f) == "0.60s");
-            REQUIRE (stringFromTimeValue (1.0f) == "1.00s");
-            REQUIRE (stringFromTimeValue (1.1f) == "1.10s");
-            REQUIRE (stringFromTimeValue (1.11f) == "1.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 0.5f) == "0.50s");
+            REQUIRE (stringFromTimeValue ((TestType) 0.6f) == "0.60s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.0f) == "1.00s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.1f) == "1.10s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.11f) == "1.11s");
         }
 
         // the second argument will be ignored in our implementation
         // but is required for juce::AudioParameterFloat's constructor
         SECTION ("returns exactly two digits of precision on seconds")
         {
-            REQUIRE (stringFromTimeValue (1.f, 6) == "1.00s");
-            REQUIRE (stringFromTimeValue (1.1f, 5) == "1.10s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.f, 6) == "1.00s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.1f, 5) == "1.10s");
 
-            REQUIRE (stringFromTimeValue (1.11111f, 5) == "1.11s");
-            REQUIRE (stringFromTimeValue (1.11111f, 6) == "1.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.11111f, 5) == "1.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 1.11111f, 6) == "1.11s");
 
-            REQUIRE (stringFromTimeValue (11.11111f, 6) == "11.11s");
-            REQUIRE (stringFromTimeValue (11.11111f, 10) == "11.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 11.11111f, 6) == "11.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 11.11111f, 10) == "11.11s");
 
-            REQUIRE (stringFromTimeValue (111.11111f, 10) == "111.11s");
-            REQUIRE (stringFromTimeValue (111.11111f, 10) == "111.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 111.11111f, 10) == "111.11s");
+            REQUIRE (stringFromTimeValue ((TestType) 111.11111f, 10) == "111.11s");
         }
 
         SECTION ("returns no digit of precision on ms")
         {
-            REQUIRE (stringFromTimeValue (0.11111f, 5) == "111ms");
-            REQUIRE (stringFromTimeValue (0.11111f, 6) == "111ms");
-            REQUIRE (stringFromTimeValue (0.11111f, 7) == "111ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.11111f, 5) == "111ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.11111f, 6) == "111ms");
+            REQUIRE (stringFromTimeValue ((TestType) 0.11111f, 7) == "111ms");
         }
     }
 
@@ -162,17 +163,17 @@ TEST_CASE ("Melatonin Parameters to/from string")
     {
         SECTION ("Lowest value is -100db")
         {
-            REQUIRE (stringFromDBValue (-100.0f) == "-100.0db");
+            REQUIRE (stringFromDBValue ((TestType) -100.0f) == "-100.0db");
         }
 
         SECTION ("Highest value is -0db")
         {
-            REQUIRE (stringFromDBValue (0.0f) == "0.0db");
+            REQUIRE (stringFromDBValue ((TestType) 0.0f) == "0.0db");
         }
 
         SECTION ("Converts to db, max 1 decimal places")
         {
-            REQUIRE (stringFromDBValue (-6.123f) == "-6.1db");
+            REQUIRE (stringFromDBValue ((TestType) -6.123f) == "-6.1db");
         }
     }
 
@@ -207,10 +208,10 @@ TEST_CASE ("Melatonin Parameters to/from string")
     {
         SECTION ("returns the value as a string")
         {
-            REQUIRE (stringFromIntValue (0.0000000000f) == "0");
-            REQUIRE (stringFromIntValue (1.00000001f) == "1");
-            REQUIRE (stringFromIntValue (2) == "2");
-            REQUIRE (stringFromIntValue (10) == "10");
+            REQUIRE (stringFromIntValue ((TestType) 0.0000000000f) == "0");
+            REQUIRE (stringFromIntValue ((TestType) 1.00000001f) == "1");
+            REQUIRE (stringFromIntValue ((TestType) 2) == "2");
+            REQUIRE (stringFromIntValue ((TestType) 10) == "10");
         }
     }
 
@@ -229,12 +230,12 @@ TEST_CASE ("Melatonin Parameters to/from string")
     {
         SECTION ("converts to a nicely formatted percentage")
         {
-            REQUIRE (stringFromPercentValue (0.0000000000f) == "0%");
-            REQUIRE (stringFromPercentValue (0.9999999f) == "100%");
-            REQUIRE (stringFromPercentValue (1.00000001f) == "100%");
-            REQUIRE (stringFromPercentValue (0.5f) == "50%");
-            REQUIRE (stringFromPercentValue (0.25f) == "25%");
-            REQUIRE (stringFromPercentValue (0.25555555f) == "25%");
+            REQUIRE (stringFromPercentValue ((TestType) 0.0000000000f) == "0%");
+            REQUIRE (stringFromPercentValue ((TestType) 0.9999999f) == "100%");
+            REQUIRE (stringFromPercentValue ((TestType) 1.00000001f) == "100%");
+            REQUIRE (stringFromPercentValue ((TestType) 0.5f) == "50%");
+            REQUIRE (stringFromPercentValue ((TestType) 0.25f) == "25%");
+            REQUIRE (stringFromPercentValue ((TestType) 0.25555555f) == "25%");
         }
     }
 
@@ -255,24 +256,24 @@ TEST_CASE ("Melatonin Parameters to/from string")
         {
             SECTION ("under 2Hz has 2 decimal places")
             {
-                REQUIRE (stringFromHzValue (0.0000000000f) == "0.00 Hz");
-                REQUIRE (stringFromHzValue (0.99f) == "0.99 Hz");
-                REQUIRE (stringFromHzValue (1.99f) == "1.99 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 0.0000000000f) == "0.00 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 0.99f) == "0.99 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 1.99f) == "1.99 Hz");
             }
 
             SECTION ("over 2Hz has single decimal precision")
             {
-                REQUIRE (stringFromHzValue (2.01f) == "2.0 Hz");
-                REQUIRE (stringFromHzValue (10.0f) == "10 Hz");
-                REQUIRE (stringFromHzValue (100.0f) == "100 Hz");
-                REQUIRE (stringFromHzValue (1234.0f) == "1234 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 2.01f) == "2.0 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 10.0f) == "10 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 100.0f) == "100 Hz");
+                REQUIRE (stringFromHzValue ((TestType) 1234.0f) == "1234 Hz");
             }
 
             SECTION ("khz gets single decimal precision")
             {
-                REQUIRE (stringFromHzValue (1500.0f) == "1.5 kHz");
-                REQUIRE (stringFromHzValue (2000.0f) == "2.0 kHz");
-                REQUIRE (stringFromHzValue (15000.0f) == "15.0 kHz");
+                REQUIRE (stringFromHzValue ((TestType) 1500.0f) == "1.5 kHz");
+                REQUIRE (stringFromHzValue ((TestType) 2000.0f) == "2.0 kHz");
+                REQUIRE (stringFromHzValue ((TestType) 15000.0f) == "15.0 kHz");
             }
         }
     }
@@ -293,3 +294,60 @@ TEST_CASE ("Melatonin Parameters to/from string")
         }
     }
 }
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters string benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    // Formats a spread of values through the range the helper would normally sit behind
+    auto benchmarkToString = [&] (const std::string& name, auto&& toString, const juce::NormalisableRange<float>& range) {
+        std::vector<float> values;
+        for (auto value : normalized)
+            values.push_back (range.convertFrom0to1 (value));
+
+        size_t i = 0;
+        BENCHMARK (name)
+        {
+            return toString (values[i++ & 1023], 5);
+        };
+
+        WARN (name << ": " << melatonin::allocations::perCall ([&] (int n) { return toString (values[(size_t) n], 5); }) << " allocations per call");
+    };
+
+    auto benchmarkFromString = [&] (const std::string& name, auto&& fromString, const std::vector<juce::String>& texts) {
+        size_t i = 0;
+        BENCHMARK (name)
+        {
+            return fromString (texts[i++ % texts.size()]);
+        };
+
+        WARN (name << ": " << melatonin::allocations::perCall ([&] (int n) { return fromString (texts[(size_t) n % texts.size()]); }) << " allocations per call");
+    };
+
+    SECTION ("to string")
+    {
+        benchmarkToString ("stringFromTimeValue", stringFromTimeValue, logarithmicRange (0.0f, 15.0f));
+        benchmarkToString ("stringFromDBValue", stringFromDBValue, decibelRange (-30.0f, 0.0f));
+        benchmarkToString ("stringFromDBValueWithOffAt64", stringFromDBValueWithOffAt64, linearRange (-64.0f, 0.0f));
+        benchmarkToString ("stringFromIntValue", stringFromIntValue, intRangeWithMidPoint (0, 100, 80));
+        benchmarkToString ("stringFromPercentValue", stringFromPercentValue, linearRange (0.0f, 1.0f));
+        benchmarkToString ("stringFromPercentValueWithDigits<2>", stringFromPercentValueWithDigits<2>, linearRange (0.0f, 1.0f));
+        benchmarkToString ("stringFromHzValue", stringFromHzValue, logarithmicRange (20.0f, 20000.0f, 10.0f));
+        benchmarkToString ("stringFromSemiValue", stringFromSemiValue, linearRange (-24.0f, 24.0f));
+        benchmarkToString ("stringFrom0to1", stringFrom0to1, linearRange (0.0f, 1.0f));
+    }
+
+    SECTION ("from string")
+    {
+        benchmarkFromString ("timeValueFromString", timeValueFromString, { "0ms", "11.1ms", "100ms", "1.0s", "15.98s", "3.5", "250" });
+        benchmarkFromString ("dBFromString", dBFromString, { "-12.5db", "0db", "-3", "-60.0db" });
+        benchmarkFromString ("dBFromStringWithOffAt64", dBFromStringWithOffAt64, { "OFF", "-12.5db", "0db", "-3" });
+        benchmarkFromString ("intValueFromString", intValueFromString, { "0", "42", "-7", "100" });
+        benchmarkFromString ("percentValueFromString", percentValueFromString, { "OFF", "50%", "12.5%", "100" });
+        benchmarkFromString ("hzValueFromString", hzValueFromString, { "440 Hz", "1.5 kHz", "20hz", "12000" });
+        benchmarkFromString ("semiValueFromString", semiValueFromString, { "-12", "0", "7 semi" });
+        benchmarkFromString ("zeroTo1FromString", zeroTo1FromString, { "0", "0.25", "1.0" });
+    }
+}
+#endif
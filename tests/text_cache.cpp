@@ -0,0 +1,121 @@
+TEST_CASE ("Melatonin Parameters text cache")
+{
+    using melatonin::formatters::Decibels;
+    using melatonin::formatters::Hz;
+    using melatonin::formatters::Time;
+
+    SECTION ("returns the same text as the lambdas, hit or miss")
+    {
+        melatonin::TextCache<Time> time;
+        melatonin::TextCache<Hz> hz;
+
+        // every value goes through twice, so the second pass is all hits
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (int i = 0; i <= 2000; ++i)
+            {
+                auto normalized = (float) i / 2000.0f;
+                auto seconds = logarithmicRange (0.0f, 15.0f).convertFrom0to1 (normalized);
+                auto frequency = logarithmicRange (20.0f, 20000.0f, 10.0f).convertFrom0to1 (normalized);
+                CHECK (time.toString (seconds) == stringFromTimeValue (seconds));
+                CHECK (hz.toString (frequency) == stringFromHzValue (frequency));
+            }
+        }
+    }
+
+    SECTION ("keeps values with the same display apart from ones without")
+    {
+        melatonin::TextCache<Decibels, 1> decibels;
+        std::array<char, 16> text;
+        CHECK (decibels.format (-6.11f, text) == "-6.1db");
+        CHECK (decibels.format (-6.09f, text) == "-6.1db");
+        CHECK (decibels.format (-6.16f, text) == "-6.2db");
+        CHECK (decibels.format (-0.01f, text) == "-0.0db");
+        CHECK (decibels.format (0.01f, text) == "0.0db");
+    }
+
+    SECTION ("the lambda replacement uses maximumStringLength like the original")
+    {
+        auto cached = melatonin::cachedStringFrom<melatonin::formatters::ZeroTo1>();
+        CHECK (cached (0.123456f, 2) == stringFrom0to1 (0.123456f, 2));
+        CHECK (cached (0.123456f, 4) == stringFrom0to1 (0.123456f, 4));
+        CHECK (cached (0.123456f, 2) == "0.12");
+    }
+
+    SECTION ("reports when the displayed text would change")
+    {
+        melatonin::DisplayValue lastDisplayed;
+        CHECK (melatonin::TextCache<Decibels>::hasChanged (-6.11f, lastDisplayed));
+        CHECK_FALSE (melatonin::TextCache<Decibels>::hasChanged (-6.09f, lastDisplayed));
+        CHECK_FALSE (melatonin::TextCache<Decibels>::hasChanged (-6.1f, lastDisplayed));
+        CHECK (melatonin::TextCache<Decibels>::hasChanged (-6.2f, lastDisplayed));
+
+        CHECK (melatonin::TextCache<Time>::hasChanged (0.4999f, lastDisplayed));
+        CHECK (melatonin::TextCache<Time>::hasChanged (0.5f, lastDisplayed));
+    }
+
+    SECTION ("text too long for a slot is still returned, just not cached")
+    {
+        melatonin::TextCache<melatonin::formatters::ZeroTo1, 4, 4> cache;
+        std::array<char, 32> text;
+        CHECK (cache.format (0.123456f, text, 6) == "0.123456");
+        CHECK (cache.format (0.123456f, text, 6) == "0.123456");
+        CHECK (cache.format (0.5f, text, 1) == "0.5");
+    }
+
+    SECTION ("readers on other threads always see whole texts")
+    {
+        melatonin::TextCache<Hz, 4> cache;
+        std::atomic<bool> done { false };
+        std::atomic<int> mismatches { 0 };
+
+        auto hammer = [&] (int seed) {
+            std::array<char, 32> text, expected;
+            for (int i = 0; ! done.load(); ++i)
+            {
+                auto frequency = (float) ((i * 7919 + seed) % 20000) + 0.25f;
+                if (cache.format (frequency, text) != melatonin::format<Hz> (frequency, expected))
+                    ++mismatches;
+            }
+        };
+
+        std::thread first (hammer, 1), second (hammer, 2), third (hammer, 3);
+        std::this_thread::sleep_for (std::chrono::milliseconds (100));
+        done = true;
+        first.join();
+        second.join();
+        third.join();
+
+        CHECK (mismatches.load() == 0);
+    }
+}
+
+#if RUN_MELATONIN_BENCHMARKS
+TEST_CASE ("Melatonin Parameters text cache benchmarks", "[!benchmark]")
+{
+    const auto normalized = melatonin::benchmarks::normalizedValues();
+
+    SECTION ("through a text cache")
+    {
+        // a slowly moving value, like a knob being dragged, so most calls repeat the displayed text
+        std::vector<float> values;
+        for (auto value : normalized)
+            values.push_back (decibelRange (-30.0f, 0.0f).convertFrom0to1 (value * 0.01f));
+
+        melatonin::TextCache<melatonin::formatters::Decibels> cache;
+        std::array<char, 32> text;
+        size_t i = 0;
+        BENCHMARK ("melatonin::TextCache<Decibels>")
+        {
+            return cache.format (values[i++ & 1023], text).size();
+        };
+
+        BENCHMARK ("melatonin::format<Decibels> on the same values")
+        {
+            return melatonin::format<melatonin::formatters::Decibels> (values[i++ & 1023], text).size();
+        };
+
+        CHECK (melatonin::allocations::perCall ([&] (int n) { return cache.format (values[(size_t) n], text).size(); }) == 0);
+    }
+}
+#endif